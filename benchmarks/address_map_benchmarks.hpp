@@ -0,0 +1,74 @@
+/**
+ * @file   address_map_benchmarks.hpp
+ * @author Pratchaya Khansomboon (me@mononerv.dev)
+ * @brief  Address to index lookup, sky::address_map against a linear find_if over the table.
+ * @date   2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ */
+#ifndef BENCHMARKS_ADDRESS_MAP_BENCHMARKS_HPP
+#define BENCHMARKS_ADDRESS_MAP_BENCHMARKS_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "address_map.hpp"
+
+// Random distinct non zero addresses and the order they are looked up in.
+static auto address_map_bench_keys(std::size_t count, std::vector<std::uint32_t>& keys, std::vector<std::uint32_t>& lookups) -> void {
+    std::mt19937 rng{1};
+    keys.clear();
+    for (std::uint32_t i = 0; i < count; ++i) keys.push_back((i * 2654435761u + 1) & 0xFFFFFF);
+    lookups = keys;
+    std::shuffle(lookups.begin(), lookups.end(), rng);
+}
+
+template <std::size_t COUNT>
+static auto bm_address_map_find(benchmark::State& state) -> void {
+    std::vector<std::uint32_t> keys{};
+    std::vector<std::uint32_t> lookups{};
+    address_map_bench_keys(COUNT, keys, lookups);
+    auto map = std::make_unique<sky::address_map<COUNT>>();
+    for (auto const key : keys) {
+        sky::address_t address{};
+        sky::mcp_u32_to_address(address, key);
+        map->insert(address);
+    }
+    std::size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(map->find(lookups[i]));
+        if (++i == lookups.size()) i = 0;
+    }
+    state.counters["bytes"] = sizeof(sky::address_map<COUNT>);
+}
+
+// What main.cpp did, find_if comparing every address in the table.
+template <std::size_t COUNT>
+static auto bm_address_linear_find(benchmark::State& state) -> void {
+    std::vector<std::uint32_t> keys{};
+    std::vector<std::uint32_t> lookups{};
+    address_map_bench_keys(COUNT, keys, lookups);
+    auto table = std::make_unique<sky::address_t[]>(COUNT);
+    for (std::size_t k = 0; k < COUNT; ++k) sky::mcp_u32_to_address(table[k], keys[k]);
+    std::size_t i = 0;
+    for (auto _ : state) {
+        sky::address_t address{};
+        sky::mcp_u32_to_address(address, lookups[i]);
+        auto const it = std::find_if(table.get(), table.get() + COUNT, [&address](sky::address_t const& a) {
+            return sky::mcp_address_to_u32(a) == sky::mcp_address_to_u32(address);
+        });
+        benchmark::DoNotOptimize(it);
+        if (++i == lookups.size()) i = 0;
+    }
+}
+
+BENCHMARK_TEMPLATE(bm_address_map_find, 16);
+BENCHMARK_TEMPLATE(bm_address_linear_find, 16);
+BENCHMARK_TEMPLATE(bm_address_map_find, 4096);
+BENCHMARK_TEMPLATE(bm_address_linear_find, 4096);
+
+#endif  // !BENCHMARKS_ADDRESS_MAP_BENCHMARKS_HPP
@@ -0,0 +1,31 @@
+/**
+ * @file   benchmarkrunner.cpp
+ * @author Pratchaya Khansomboon (me@mononerv.dev)
+ * @brief  Benchmark runner
+ * @date   2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ */
+#include "benchmark/benchmark.h"
+#include "sky.hpp"
+
+#include "address_map_benchmarks.hpp"
+#include "crc_benchmarks.hpp"
+#include "mcp_benchmarks.hpp"
+#include "mesh_benchmarks.hpp"
+#include "queue_benchmarks.hpp"
+#include "topo_benchmarks.hpp"
+
+auto main(int argc, char const* argv[]) -> int {
+    benchmark::Initialize(&argc, (char**)argv);
+    // Printed with the results, numbers from an unoptimised build say little about the code
+#ifdef NDEBUG
+    benchmark::AddCustomContext("build", "release");
+#else
+    benchmark::AddCustomContext("build", "debug, not for comparing");
+#endif
+    if (benchmark::ReportUnrecognizedArguments(argc, (char**)argv)) return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,54 @@
+/**
+ * @file   crc_benchmarks.hpp
+ * @author Pratchaya Khansomboon (me@mononerv.dev)
+ * @brief  Throughput of the CRC-8 kernels in bytes/s.
+ * @date   2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ */
+#ifndef BENCHMARKS_CRC_BENCHMARKS_HPP
+#define BENCHMARKS_CRC_BENCHMARKS_HPP
+
+#include <random>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "crc.hpp"
+#include "mcp.hpp"
+
+static auto crc_random_data(std::size_t size) -> std::vector<std::uint8_t> {
+    std::mt19937 rng{42};
+    std::uniform_int_distribution<int> byte{0, 255};
+    std::vector<std::uint8_t> data(size);
+    for (auto& b : data) b = static_cast<std::uint8_t>(byte(rng));
+    return data;
+}
+
+template <sky::crc_kernel KERNEL>
+static auto bm_crc_8(benchmark::State& state) -> void {
+    auto const size = static_cast<std::size_t>(state.range(0));
+    auto const data = crc_random_data(size);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sky::crc_8_compute(KERNEL, data.data(), size));
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * size));
+}
+
+static auto bm_crc_8_dispatch(benchmark::State& state) -> void {
+    auto const size = static_cast<std::size_t>(state.range(0));
+    auto const data = crc_random_data(size);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sky::crc_8(data.data(), size));
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * size));
+}
+
+#define CRC_SIZES Arg(sky::mcp_buffer_size - 1)->Arg(16)->Arg(32)->Arg(64)->Arg(256)->Arg(4096)
+BENCHMARK_TEMPLATE(bm_crc_8, sky::crc_kernel::bitwise)->CRC_SIZES;
+BENCHMARK_TEMPLATE(bm_crc_8, sky::crc_kernel::table)->CRC_SIZES;
+BENCHMARK_TEMPLATE(bm_crc_8, sky::crc_kernel::slice_4)->CRC_SIZES;
+BENCHMARK_TEMPLATE(bm_crc_8, sky::crc_kernel::slice_8)->CRC_SIZES;
+BENCHMARK(bm_crc_8_dispatch)->CRC_SIZES;
+#undef CRC_SIZES
+
+#endif  // !BENCHMARKS_CRC_BENCHMARKS_HPP
@@ -0,0 +1,183 @@
+/**
+ * @file   mcp_benchmarks.hpp
+ * @author Pratchaya Khansomboon (me@mononerv.dev)
+ * @brief  Message Control Protocol encode, decode and forwarding benchmarks.
+ * @date   2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ */
+#ifndef BENCHMARKS_MCP_BENCHMARKS_HPP
+#define BENCHMARKS_MCP_BENCHMARKS_HPP
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "mcp.hpp"
+
+static auto mcp_bench_frame() -> sky::mcp {
+    return { 1, {0x01, 0x02, 0x03}, {0x04, 0x05, 0x06}, {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15}, 0, 0 };
+}
+
+constexpr sky::address_t mcp_bench_edges[] = {
+    {0x10, 0x11, 0x12},
+    {0x20, 0x21, 0x22},
+    {0x30, 0x31, 0x32},
+    {0x40, 0x41, 0x42},
+};
+
+// Forwarding as handle_message used to: decode, rewrite destination and re-encode per channel.
+static auto bm_mcp_forward_reencode(benchmark::State& state) -> void {
+    sky::mcp_buffer_t received{};
+    sky::mcp_make_buffer(received, mcp_bench_frame());
+    sky::mcp_buffer_t out[4]{};
+    for (auto _ : state) {
+        sky::mcp_buffer_t buffer{};
+        std::memcpy(buffer, received, sky::mcp_buffer_size);
+        auto mcp = sky::mcp_make_from_buffer(buffer);
+        for (std::size_t i = 1; i < 4; ++i) {
+            std::memcpy(mcp.destination, mcp_bench_edges[i], sky::address_size);
+            sky::mcp_make_buffer(out[i], mcp);
+        }
+        benchmark::DoNotOptimize(out);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * 3));
+}
+
+// Copy the frame per channel and recompute the CRC over the whole frame.
+static auto bm_mcp_forward_full_crc(benchmark::State& state) -> void {
+    sky::mcp_buffer_t received{};
+    sky::mcp_make_buffer(received, mcp_bench_frame());
+    sky::mcp_buffer_t out[4]{};
+    for (auto _ : state) {
+        for (std::size_t i = 1; i < 4; ++i) {
+            std::memcpy(out[i], received, sky::mcp_buffer_size);
+            std::memcpy(out[i] + sky::mcp_destination_offset, mcp_bench_edges[i], sky::address_size);
+            sky::mcp_mut_view{out[i]}.update_crc();
+        }
+        benchmark::DoNotOptimize(out);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * 3));
+}
+
+// Copy the frame per channel and patch the CRC from the destination bytes only.
+static auto bm_mcp_forward_incremental_crc(benchmark::State& state) -> void {
+    sky::mcp_buffer_t received{};
+    sky::mcp_make_buffer(received, mcp_bench_frame());
+    sky::mcp_buffer_t out[4]{};
+    for (auto _ : state) {
+        for (std::size_t i = 1; i < 4; ++i) {
+            std::memcpy(out[i], received, sky::mcp_buffer_size);
+            sky::mcp_mut_view{out[i]}.set_destination(mcp_bench_edges[i]);
+        }
+        benchmark::DoNotOptimize(out);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * 3));
+}
+
+static auto mcp_bench_frames(std::size_t count) -> std::vector<sky::mcp> {
+    std::mt19937 rng{42};
+    std::uniform_int_distribution<int> byte{0, 255};
+    std::vector<sky::mcp> frames(count);
+    for (auto& frame : frames) {
+        auto* raw = reinterpret_cast<std::uint8_t*>(&frame);
+        for (std::size_t i = 0; i < sizeof(sky::mcp); ++i) raw[i] = static_cast<std::uint8_t>(byte(rng));
+    }
+    return frames;
+}
+
+static auto bm_mcp_encode_loop(benchmark::State& state) -> void {
+    auto const count = static_cast<std::size_t>(state.range(0));
+    auto const frames = mcp_bench_frames(count);
+    std::vector<sky::mcp_buffer_t> buffers(count);
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < count; ++i) sky::mcp_make_buffer(buffers[i], frames[i]);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * count));
+}
+
+static auto bm_mcp_encode_batch(benchmark::State& state) -> void {
+    auto const count = static_cast<std::size_t>(state.range(0));
+    auto const frames = mcp_bench_frames(count);
+    std::vector<sky::mcp_buffer_t> buffers(count);
+    for (auto _ : state) {
+        sky::mcp_encode_batch(buffers.data(), frames.data(), count);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * count));
+}
+
+static auto bm_mcp_decode_loop(benchmark::State& state) -> void {
+    auto const count = static_cast<std::size_t>(state.range(0));
+    auto const frames = mcp_bench_frames(count);
+    std::vector<sky::mcp_buffer_t> buffers(count);
+    sky::mcp_encode_batch(buffers.data(), frames.data(), count);
+    std::vector<sky::mcp> decoded(count);
+    for (auto _ : state) {
+        std::size_t valid = 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            decoded[i] = sky::mcp_make_from_buffer(buffers[i]);
+            valid += sky::mcp_check_crc(buffers[i]);
+        }
+        benchmark::DoNotOptimize(valid);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * count));
+}
+
+static auto bm_mcp_decode_batch(benchmark::State& state) -> void {
+    auto const count = static_cast<std::size_t>(state.range(0));
+    auto const frames = mcp_bench_frames(count);
+    std::vector<sky::mcp_buffer_t> buffers(count);
+    sky::mcp_encode_batch(buffers.data(), frames.data(), count);
+    std::vector<sky::mcp> decoded(count);
+    std::vector<std::uint32_t> valid(sky::mcp_batch_mask_words(count));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sky::mcp_decode_batch(decoded.data(), buffers.data(), count, valid.data()));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * count));
+}
+
+static auto bm_mcp_check_crc_loop(benchmark::State& state) -> void {
+    auto const count = static_cast<std::size_t>(state.range(0));
+    auto const frames = mcp_bench_frames(count);
+    std::vector<sky::mcp_buffer_t> buffers(count);
+    sky::mcp_encode_batch(buffers.data(), frames.data(), count);
+    for (auto _ : state) {
+        std::size_t valid = 0;
+        for (std::size_t i = 0; i < count; ++i) valid += sky::mcp_check_crc(buffers[i]);
+        benchmark::DoNotOptimize(valid);
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * count));
+}
+
+static auto bm_mcp_check_crc_batch(benchmark::State& state) -> void {
+    auto const count = static_cast<std::size_t>(state.range(0));
+    auto const frames = mcp_bench_frames(count);
+    std::vector<sky::mcp_buffer_t> buffers(count);
+    sky::mcp_encode_batch(buffers.data(), frames.data(), count);
+    std::vector<std::uint32_t> valid(sky::mcp_batch_mask_words(count));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sky::mcp_check_crc_batch(buffers.data(), count, valid.data()));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * count));
+}
+
+BENCHMARK(bm_mcp_forward_reencode);
+BENCHMARK(bm_mcp_forward_full_crc);
+BENCHMARK(bm_mcp_forward_incremental_crc);
+BENCHMARK(bm_mcp_encode_loop)->Arg(1024)->Arg(16384);
+BENCHMARK(bm_mcp_encode_batch)->Arg(1024)->Arg(16384);
+BENCHMARK(bm_mcp_decode_loop)->Arg(1024)->Arg(16384);
+BENCHMARK(bm_mcp_decode_batch)->Arg(1024)->Arg(16384);
+BENCHMARK(bm_mcp_check_crc_loop)->Arg(1024)->Arg(16384);
+BENCHMARK(bm_mcp_check_crc_batch)->Arg(1024)->Arg(16384);
+
+#endif  // !BENCHMARKS_MCP_BENCHMARKS_HPP
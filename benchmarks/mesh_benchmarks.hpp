@@ -0,0 +1,204 @@
+/**
+ * @file   mesh_benchmarks.hpp
+ * @author Pratchaya Khansomboon (me@mononerv.dev)
+ * @brief  Mesh simulator scaling over worker threads.
+ * @date   2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ */
+#ifndef BENCHMARKS_MESH_BENCHMARKS_HPP
+#define BENCHMARKS_MESH_BENCHMARKS_HPP
+
+#include <cstdint>
+
+#include "benchmark/benchmark.h"
+#include "mesh.hpp"
+
+// A 64x64 building through boot and discovery, the same run for every thread count.
+static auto bm_mesh_grid_threads(benchmark::State& state) -> void {
+    ray::mesh_config config{};
+    config.threads = static_cast<std::size_t>(state.range(0));
+    ray::mesh_report report{};
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto sim = ray::make_grid_mesh(64, 64, config);
+        sim->set_exit(0);
+        state.ResumeTiming();
+        sim->run_until(5'000'000);
+        report = sim->report();
+        benchmark::DoNotOptimize(report);
+    }
+    state.counters["events"]  = benchmark::Counter(static_cast<double>(report.events), benchmark::Counter::kIsIterationInvariantRate);
+    state.counters["windows"] = static_cast<double>(report.windows);
+    state.counters["frames"]  = static_cast<double>(report.frames);
+}
+
+BENCHMARK(bm_mesh_grid_threads)->ArgName("threads")->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Arg(16)
+    ->Unit(benchmark::kMillisecond)->UseRealTime()->Iterations(3);
+
+// Same 10x10 building under each multicom slot policy. Wall time is the simulator's cost,
+// the counters are how the mesh did: frames delivered per virtual second and how long the
+// exit took to reach every light, in virtual milliseconds.
+static auto bm_mesh_schedule(benchmark::State& state) -> void {
+    ray::mesh_config config{};
+    config.schedule = static_cast<ray::mesh_schedule>(state.range(0));
+    ray::mesh_report report{};
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto sim = ray::make_grid_mesh(10, 10, config);
+        sim->set_exit(0);
+        state.ResumeTiming();
+        sim->run_until(60'000'000);
+        report = sim->report();
+        benchmark::DoNotOptimize(report);
+    }
+    auto const seconds = static_cast<double>(report.now_us) / 1e6;
+    state.counters["frames_per_virtual_s"] = static_cast<double>(report.frames) / seconds;
+    state.counters["exit_reached_ms"]      = static_cast<double>(report.exit_reached_us) / 1000.0;
+    state.counters["edges_verified_ms"]    = static_cast<double>(report.edges_verified_us) / 1000.0;
+    state.counters["bytes_lost"]           = static_cast<double>(report.bytes_lost);
+}
+
+BENCHMARK(bm_mesh_schedule)->ArgName("adaptive")->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond)->Iterations(1);
+
+// Back to back sends per slot on the adaptive schedule, the argument is the burst time in ms.
+// Counts how many packets went out per sending slot and how long an out queue took to empty.
+static auto bm_mesh_burst(benchmark::State& state) -> void {
+    ray::mesh_config config{};
+    config.schedule = ray::mesh_schedule::adaptive;
+    config.burst_us = static_cast<uint32_t>(state.range(0) * 1000);
+    ray::mesh_report report{};
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto sim = ray::make_grid_mesh(10, 10, config);
+        sim->set_exit(0);
+        state.ResumeTiming();
+        sim->run_until(60'000'000);
+        report = sim->report();
+        benchmark::DoNotOptimize(report);
+    }
+    auto const seconds = static_cast<double>(report.now_us) / 1e6;
+    state.counters["packets_per_slot"]     = static_cast<double>(report.packets_sent) / static_cast<double>(report.send_slots);
+    state.counters["drain_ms"]             = static_cast<double>(report.mean_drain_us) / 1000.0;
+    state.counters["frames_per_virtual_s"] = static_cast<double>(report.frames) / seconds;
+    state.counters["exit_reached_ms"]      = static_cast<double>(report.exit_reached_us) / 1000.0;
+}
+
+BENCHMARK(bm_mesh_burst)->ArgName("burst_ms")->Arg(0)->Arg(50)->Arg(100)->Arg(200)->Unit(benchmark::kMillisecond)->Iterations(1);
+
+// The board's link settings with and without merging repeated writes on a 10x10 grid for 60 s,
+// one run per seed so a bad seed shows on its own line. fire_nodes has to stay 0.
+static auto bm_mesh_coalesce(benchmark::State& state) -> void {
+    ray::mesh_config config{};
+    config.schedule = ray::mesh_schedule::adaptive;
+    config.burst_us = 100'000;
+    config.coalesce = state.range(0) != 0;
+    config.seed = static_cast<uint64_t>(state.range(1));
+    constexpr uint64_t limit_us = 60'000'000;
+    ray::mesh_report report{};
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto sim = ray::make_grid_mesh(10, 10, config);
+        sim->set_exit(0);
+        state.ResumeTiming();
+        sim->run_until(limit_us);
+        report = sim->report();
+        benchmark::DoNotOptimize(report);
+    }
+    auto const seconds = static_cast<double>(limit_us) / 1e6;
+    state.counters["merged_per_virtual_s"]  = static_cast<double>(report.suppressed) / seconds;
+    state.counters["evicted_per_virtual_s"] = static_cast<double>(report.evicted) / seconds;
+    state.counters["frames_per_virtual_s"]  = static_cast<double>(report.frames) / seconds;
+    state.counters["exit_reached_ms"]       = report.exit_reached_us >= 0 ? static_cast<double>(report.exit_reached_us) / 1000.0 : -1.0;
+    state.counters["fire_nodes"]            = static_cast<double>(report.fire_nodes);
+}
+
+BENCHMARK(bm_mesh_coalesce)->ArgNames({"coalesce", "seed"})->ArgsProduct({{0, 1}, {1, 2, 3, 4}})
+    ->Unit(benchmark::kMillisecond)->Iterations(1);
+
+// Fire from one end of a 100 hop chain with the board's link settings, with and without fire
+// and reset frames going first, one run per seed. The far end only counts once a fire frame from
+// the burning light put it in fire mode, far_end_ms is -1 when that took over 200 s. fire_nodes
+// are the lights in fire mode at the end.
+static auto bm_mesh_fire_chain(benchmark::State& state) -> void {
+    ray::mesh_config config{};
+    config.schedule = ray::mesh_schedule::adaptive;
+    config.burst_us = 100'000;
+    config.coalesce = true;
+    config.priority = state.range(0) != 0;
+    config.seed = static_cast<uint64_t>(state.range(1));
+    constexpr uint64_t fire_at  = 45'000'000;
+    constexpr uint64_t limit_us = 200'000'000;
+    uint64_t    latency_us = 0;
+    std::size_t fire_nodes = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto sim = ray::make_grid_mesh(101, 1, config);
+        sim->set_exit(100);
+        sim->set_fire(0, fire_at);
+        state.ResumeTiming();
+        auto const origin = sky::mcp_address_to_u32(sim->at(0).address());
+        auto const reached = [&sim, origin] {
+            return sim->at(100).state() == ray::node_state::fire && sky::mcp_address_to_u32(sim->at(100).fire_source()) == origin;
+        };
+        auto now = fire_at;
+        sim->run_until(now);
+        while (now - fire_at < limit_us && !reached()) {
+            now += 500'000;
+            sim->run_until(now);
+        }
+        latency_us = now - fire_at;
+        fire_nodes = sim->report().fire_nodes;
+    }
+    state.counters["far_end_ms"] = latency_us < limit_us ? static_cast<double>(latency_us) / 1000.0 : -1.0;
+    state.counters["fire_nodes"] = static_cast<double>(fire_nodes);
+}
+
+BENCHMARK(bm_mesh_fire_chain)->ArgNames({"priority", "seed"})->ArgsProduct({{0, 1}, {1, 2, 3, 4}})
+    ->Unit(benchmark::kMillisecond)->Iterations(1);
+
+// Topology flooded every 125 ms against link-state gossip on a 4x4 and a 16x16 grid, the
+// simulator's host_node holds the whole 16x16 grid. The board's link settings for 90 s on the
+// 4x4 and 600 s on the 16x16, one run per seed so a bad seed shows on its own line. A run has
+// converged once 99 % of the verified edges are in every node's topology, checked every second.
+// fire_nodes has to stay 0, there is no fire switch.
+static auto bm_mesh_gossip(benchmark::State& state) -> void {
+    auto const width = static_cast<std::size_t>(state.range(0));
+    ray::mesh_config config{};
+    config.schedule = ray::mesh_schedule::adaptive;
+    config.burst_us = 100'000;
+    config.coalesce = true;
+    config.priority = true;
+    config.link_state = state.range(1) != 0;
+    config.seed = static_cast<uint64_t>(state.range(2));
+    uint64_t const limit_us = width > 4 ? 600'000'000 : 90'000'000;
+    ray::mesh_report report{};
+    double   coverage = 0.0;
+    uint64_t done_us  = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto sim = ray::make_grid_mesh(width, width, config);
+        sim->set_exit(0);
+        state.ResumeTiming();
+        done_us = 0;
+        for (uint64_t now = 1'000'000; now <= limit_us; now += 1'000'000) {
+            sim->run_until(now);
+            if (done_us == 0 && sim->topology_coverage() >= 0.99) done_us = now;
+        }
+        report   = sim->report();
+        coverage = sim->topology_coverage();
+    }
+    auto const seconds = static_cast<double>(limit_us) / 1e6;
+    state.counters["topology_writes"]               = static_cast<double>(report.topology_writes);
+    state.counters["topology_writes_per_virtual_s"] = static_cast<double>(report.topology_writes) / seconds;
+    state.counters["frames_per_virtual_s"]          = static_cast<double>(report.frames) / seconds;
+    state.counters["coverage"]                      = coverage;
+    state.counters["converged_ms"]                  = done_us > 0 ? static_cast<double>(done_us) / 1000.0 : -1.0;
+    state.counters["last_new_address_ms"]           = static_cast<double>(report.topology_us) / 1000.0;
+    state.counters["fire_nodes"]                    = static_cast<double>(report.fire_nodes);
+}
+
+BENCHMARK(bm_mesh_gossip)->ArgNames({"width", "link_state", "seed"})->ArgsProduct({{4, 16}, {0, 1}, {1, 2, 3, 4}})
+    ->Unit(benchmark::kMillisecond)->Iterations(1);
+
+#endif  // !BENCHMARKS_MESH_BENCHMARKS_HPP
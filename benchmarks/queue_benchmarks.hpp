@@ -0,0 +1,108 @@
+/**
+ * @file   queue_benchmarks.hpp
+ * @author Pratchaya Khansomboon (me@mononerv.dev)
+ * @brief  Cross thread throughput and latency of sky::spsc_queue against a mutex guarded sky::queue.
+ * @date   2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ */
+#ifndef BENCHMARKS_QUEUE_BENCHMARKS_HPP
+#define BENCHMARKS_QUEUE_BENCHMARKS_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#include "benchmark/benchmark.h"
+#include "mcp.hpp"
+#include "queue.hpp"
+#include "spsc_queue.hpp"
+
+// sky::queue behind a mutex with the same interface as sky::spsc_queue, full means retry.
+template <typename T, std::size_t SIZE>
+class queue_bench_locked {
+public:
+    [[nodiscard]] auto try_enq(T data) -> bool {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        if (m_queue.size() == m_queue.capacity()) return false;
+        m_queue.enq(std::move(data));
+        return true;
+    }
+    [[nodiscard]] auto try_deq(T& out) -> bool {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        if (m_queue.empty()) return false;
+        out = m_queue.deq();
+        return true;
+    }
+
+private:
+    std::mutex          m_mutex{};
+    sky::queue<T, SIZE> m_queue{};
+};
+
+// Frames moved from a producer thread to a consumer thread, reported as items/s.
+// Both sides yield when blocked so the numbers stay meaningful on few cores.
+template <typename Queue>
+static auto bm_queue_throughput(benchmark::State& state) -> void {
+    constexpr std::uint64_t batch = 1 << 14;
+    Queue queue{};
+    std::atomic<bool> running{true};
+    std::atomic<std::uint64_t> consumed{0};
+    std::thread consumer([&] {
+        sky::mcp frame{};
+        std::uint64_t count = 0;
+        while (running.load(std::memory_order_relaxed)) {
+            if (queue.try_deq(frame)) consumed.store(++count, std::memory_order_release);
+            else std::this_thread::yield();
+        }
+    });
+
+    sky::mcp frame{};
+    std::uint64_t produced = 0;
+    for (auto _ : state) {
+        for (std::uint64_t i = 0; i < batch; ++i) {
+            frame.payload[0] = static_cast<std::uint8_t>(i);
+            while (!queue.try_enq(frame)) std::this_thread::yield();
+        }
+        produced += batch;
+        while (consumed.load(std::memory_order_acquire) != produced) std::this_thread::yield();
+    }
+    running.store(false, std::memory_order_relaxed);
+    consumer.join();
+    state.SetItemsProcessed(static_cast<std::int64_t>(produced));
+}
+
+// Round trip of one value through a request and a reply queue.
+template <typename Queue>
+static auto bm_queue_latency(benchmark::State& state) -> void {
+    Queue request{};
+    Queue reply{};
+    std::atomic<bool> running{true};
+    std::thread echo([&] {
+        std::uint64_t value = 0;
+        while (running.load(std::memory_order_relaxed)) {
+            if (!request.try_deq(value)) {
+                std::this_thread::yield();
+                continue;
+            }
+            while (!reply.try_enq(value)) std::this_thread::yield();
+        }
+    });
+
+    std::uint64_t value = 0;
+    for (auto _ : state) {
+        while (!request.try_enq(value)) std::this_thread::yield();
+        while (!reply.try_deq(value)) std::this_thread::yield();
+        ++value;
+    }
+    running.store(false, std::memory_order_relaxed);
+    echo.join();
+}
+
+BENCHMARK_TEMPLATE(bm_queue_throughput, sky::spsc_queue<sky::mcp, 256>)->UseRealTime();
+BENCHMARK_TEMPLATE(bm_queue_throughput, queue_bench_locked<sky::mcp, 256>)->UseRealTime();
+BENCHMARK_TEMPLATE(bm_queue_latency, sky::spsc_queue<std::uint64_t, 16>)->UseRealTime();
+BENCHMARK_TEMPLATE(bm_queue_latency, queue_bench_locked<std::uint64_t, 16>)->UseRealTime();
+
+#endif  // !BENCHMARKS_QUEUE_BENCHMARKS_HPP
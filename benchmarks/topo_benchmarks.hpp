@@ -0,0 +1,272 @@
+/**
+ * @file   topo_benchmarks.hpp
+ * @author Pratchaya Khansomboon (me@mononerv.dev)
+ * @brief  Shortest path on the dense matrix and the sparse row topology.
+ * @date   2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ */
+#ifndef BENCHMARKS_TOPO_BENCHMARKS_HPP
+#define BENCHMARKS_TOPO_BENCHMARKS_HPP
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "topo.hpp"
+#include "sparse_topo.hpp"
+#include "exit_tree.hpp"
+#include "../tests/topo_reference.hpp"
+
+// Lights in a square grid with 4 links each, like the building layout.
+constexpr auto topo_bench_side(std::size_t nodes) -> std::uint32_t {
+    std::uint32_t side = 1;
+    while (side * side < nodes) ++side;
+    return side;
+}
+
+template <std::size_t N, typename Index>
+static auto topo_bench_grid(sky::basic_topo<N, Index>& topology) -> void {
+    constexpr auto side = topo_bench_side(N);
+    for (std::size_t i = 0; i < N; ++i)
+        for (std::size_t j = 0; j < N; ++j)
+            topology.matrix[i][j] = i == j ? 0 : -1;
+    for (std::uint32_t i = 0; i < N; ++i) {
+        if ((i % side) + 1 < side) sky::topo_set_node_link_cost(topology, i, i + 1, 1);
+        if (i + side < N) sky::topo_set_node_link_cost(topology, i, i + side, 1);
+    }
+}
+
+static auto topo_bench_dense_grid() -> sky::topo {
+    sky::topo topology{};
+    topo_bench_grid(topology);
+    return topology;
+}
+
+// Every node linked to every other, costs 1 or 1-9.
+static auto topo_bench_dense_full(bool weighted) -> sky::topo {
+    sky::topo topology{};
+    for (std::size_t i = 0; i < sky::node_size; ++i)
+        for (std::size_t j = 0; j < sky::node_size; ++j)
+            topology.matrix[i][j] = i == j ? 0 : static_cast<std::int8_t>(weighted ? 1 + (i * 7 + j * 3) % 9 : 1);
+    for (std::size_t i = 0; i < sky::node_size; ++i)
+        for (std::size_t j = 0; j < i; ++j)
+            topology.matrix[i][j] = topology.matrix[j][i];
+    return topology;
+}
+
+enum class topo_bench_shape : std::int64_t {
+    grid,
+    full,
+    full_weighted,
+};
+
+static auto topo_bench_shape_topology(std::int64_t shape) -> sky::topo {
+    switch (static_cast<topo_bench_shape>(shape)) {
+    case topo_bench_shape::grid:          return topo_bench_dense_grid();
+    case topo_bench_shape::full:          return topo_bench_dense_full(false);
+    case topo_bench_shape::full_weighted: return topo_bench_dense_full(true);
+    }
+    return topo_bench_dense_grid();
+}
+
+// Every pair of nodes, the array based reference against the bitmask engine.
+template <bool REFERENCE>
+static auto bm_topo_dijkstra_all_pairs(benchmark::State& state) -> void {
+    auto const topology = topo_bench_shape_topology(state.range(0));
+    for (auto _ : state) {
+        for (std::int32_t src = 1; src <= static_cast<std::int32_t>(sky::node_size); ++src) {
+            for (std::int32_t dest = 1; dest <= static_cast<std::int32_t>(sky::node_size); ++dest) {
+                sky::topo_shortest_t path{};
+                if constexpr (REFERENCE) topo_compute_dijkstra_reference(topology, src, dest, path);
+                else sky::topo_compute_dijkstra(topology, src, dest, path);
+                benchmark::DoNotOptimize(path);
+            }
+        }
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * sky::node_size * sky::node_size));
+}
+
+template <std::size_t NODES>
+using topo_bench_sparse_t = sky::sparse_topo<NODES, NODES * 4>;
+
+template <std::size_t NODES>
+static auto topo_bench_sparse_grid(topo_bench_sparse_t<NODES>& topology) -> void {
+    constexpr auto side = topo_bench_side(NODES);
+    sky::sparse_topo_clear(topology);
+    for (std::uint32_t i = 0; i < NODES; ++i) {
+        if ((i % side) + 1 < side) sky::sparse_topo_set_node_link_cost(topology, i, i + 1, 1);
+        if (i + side < NODES) sky::sparse_topo_set_node_link_cost(topology, i, i + side, 1);
+    }
+}
+
+// Corner to corner, the longest path in the grid.
+static auto bm_topo_dense_dijkstra(benchmark::State& state) -> void {
+    auto const topology = topo_bench_dense_grid();
+    for (auto _ : state) {
+        sky::topo_shortest_t path{};
+        sky::topo_compute_dijkstra(topology, 1, sky::node_size, path);
+        benchmark::DoNotOptimize(path);
+    }
+    state.counters["nodes"] = sky::node_size;
+    state.counters["bytes"] = sizeof(sky::topo);
+}
+
+template <std::size_t NODES>
+static auto bm_topo_sparse_dijkstra(benchmark::State& state) -> void {
+    auto topology = std::make_unique<topo_bench_sparse_t<NODES>>();
+    topo_bench_sparse_grid<NODES>(*topology);
+    std::vector<std::uint32_t> path(NODES);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sky::sparse_topo_compute_dijkstra(*topology, 0, NODES - 1, path.data(), path.size()));
+    }
+    state.counters["nodes"] = NODES;
+    state.counters["bytes"] = sizeof(topo_bench_sparse_t<NODES>);
+}
+
+// Building the whole topology link by link.
+template <std::size_t NODES>
+static auto bm_topo_sparse_build(benchmark::State& state) -> void {
+    auto topology = std::make_unique<topo_bench_sparse_t<NODES>>();
+    for (auto _ : state) {
+        topo_bench_sparse_grid<NODES>(*topology);
+        benchmark::DoNotOptimize(topology->row);
+    }
+    state.counters["nodes"] = NODES;
+}
+
+// Every node's path to the exit as savePath used to, one Dijkstra per node.
+static auto bm_topo_exit_paths_per_source(benchmark::State& state) -> void {
+    auto const topology = topo_bench_dense_grid();
+    sky::topo_shortest_t paths[sky::node_size]{};
+    for (auto _ : state) {
+        for (std::int32_t i = 0; i < static_cast<std::int32_t>(sky::node_size); ++i)
+            sky::topo_compute_dijkstra(topology, i + 1, sky::node_size, paths[i]);
+        benchmark::DoNotOptimize(paths);
+    }
+}
+
+// Same paths from one run out of the exit.
+static auto bm_topo_exit_paths_tree(benchmark::State& state) -> void {
+    auto const topology = topo_bench_dense_grid();
+    sky::topo_shortest_t paths[sky::node_size]{};
+    for (auto _ : state) {
+        sky::topo_tree_t next{};
+        sky::topo_tree_t distance{};
+        sky::topo_compute_exit_tree(topology, sky::node_size, next, distance);
+        for (std::int32_t i = 0; i < static_cast<std::int32_t>(sky::node_size); ++i)
+            sky::topo_exit_path(next, i + 1, paths[i]);
+        benchmark::DoNotOptimize(paths);
+    }
+}
+
+// Random nodes going into fire mode one after the other on a grid with the exit in a corner,
+// repairing the exit tree against rebuilding it after every fire.
+template <std::size_t NODES, bool INCREMENTAL>
+static auto bm_topo_exit_tree_fire(benchmark::State& state) -> void {
+    using tree_t = sky::exit_tree<NODES, NODES * 4>;
+    constexpr std::size_t fires = 8;
+    auto pristine = std::make_unique<topo_bench_sparse_t<NODES>>();
+    auto pristine_tree = std::make_unique<tree_t>();
+    topo_bench_sparse_grid<NODES>(*pristine);
+    pristine_tree->build(*pristine, 0);
+
+    std::mt19937 rng{42};
+    std::uniform_int_distribution<std::uint32_t> pick(1, NODES - 1);
+    std::vector<std::uint32_t> sequence(fires * 16);
+    for (auto& node : sequence) node = pick(rng);
+
+    auto topology = std::make_unique<topo_bench_sparse_t<NODES>>();
+    auto tree = std::make_unique<tree_t>();
+    std::size_t round = 0;
+    std::size_t changed = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        *topology = *pristine;
+        *tree = *pristine_tree;
+        auto const first = (round++ % 16) * fires;
+        state.ResumeTiming();
+        for (auto i = first; i < first + fires; ++i) {
+            if constexpr (INCREMENTAL) {
+                tree->set_node_firemode(*topology, sequence[i]);
+            } else {
+                sky::sparse_topo_set_node_firemode(*topology, sequence[i]);
+                tree->build(*topology, 0);
+            }
+            changed += tree->changed_count();
+        }
+        benchmark::DoNotOptimize(tree->next(NODES - 1));
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * fires));
+    state.counters["changed"] = benchmark::Counter(static_cast<double>(changed), benchmark::Counter::kAvgIterations);
+}
+
+// Evacuation routing on the grid and the full building, exit in one corner. Rounds 0 is the
+// plain nearest exit tree, max_load is the most nodes sent down one link.
+static auto bm_topo_balanced_exits(benchmark::State& state) -> void {
+    auto const topology = topo_bench_shape_topology(state.range(0));
+    auto const rounds = static_cast<std::size_t>(state.range(1));
+    std::int32_t const exits[] = {1};
+    sky::topo::capacity_t capacity{};
+    for (auto& row : capacity)
+        for (auto& link : row) link = 2;
+    sky::topo_tree_t next{};
+    std::int32_t max_load = 0;
+    for (auto _ : state) {
+        max_load = sky::topo_compute_balanced_exits(topology, exits, 1, capacity, rounds, next);
+        benchmark::DoNotOptimize(next);
+    }
+    state.counters["max_load"] = max_load;
+}
+
+// Every node's path out written to one table and read back, like the animation does. The
+// table is N^2 ids, so the index type decides how much of it stays in cache.
+template <std::size_t N, typename Index>
+static auto bm_topo_index_paths(benchmark::State& state) -> void {
+    using topo_t = sky::basic_topo<N, Index>;
+    auto topology = std::make_unique<topo_t>();
+    topo_bench_grid(*topology);
+    typename topo_t::tree_t next{};
+    typename topo_t::cost_t distance{};
+    sky::topo_compute_exit_tree(*topology, 1, next, distance);
+
+    auto paths = std::make_unique<typename topo_t::path_t[]>(N);
+    for (auto _ : state) {
+        for (std::size_t src = 0; src < N; ++src) sky::topo_exit_path(next, static_cast<std::int32_t>(src + 1), paths[src]);
+        std::uint64_t sum = 0;
+        for (std::size_t src = 0; src < N; ++src)
+            for (std::size_t i = 0; i < N; ++i) sum += static_cast<std::uint64_t>(paths[src][i]);
+        benchmark::DoNotOptimize(sum);
+    }
+    state.counters["bytes"] = static_cast<double>(sizeof(typename topo_t::path_t) * N);
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * N));
+}
+
+BENCHMARK(bm_topo_dense_dijkstra);
+BENCHMARK_TEMPLATE(bm_topo_dijkstra_all_pairs, true)->ArgName("shape")->DenseRange(0, 2);
+BENCHMARK_TEMPLATE(bm_topo_dijkstra_all_pairs, false)->ArgName("shape")->DenseRange(0, 2);
+BENCHMARK(bm_topo_exit_paths_per_source);
+BENCHMARK(bm_topo_exit_paths_tree);
+BENCHMARK_TEMPLATE(bm_topo_index_paths, 16, std::int32_t);
+BENCHMARK_TEMPLATE(bm_topo_index_paths, 16, std::uint8_t);
+BENCHMARK_TEMPLATE(bm_topo_index_paths, 256, std::int32_t);
+BENCHMARK_TEMPLATE(bm_topo_index_paths, 256, std::uint16_t);
+BENCHMARK_TEMPLATE(bm_topo_index_paths, 1024, std::int32_t);
+BENCHMARK_TEMPLATE(bm_topo_index_paths, 1024, std::uint16_t);
+BENCHMARK(bm_topo_balanced_exits)->ArgNames({"shape", "rounds"})->ArgsProduct({{0, 2}, {0, 1, 4, 16}});
+BENCHMARK_TEMPLATE(bm_topo_sparse_dijkstra, 16);
+BENCHMARK_TEMPLATE(bm_topo_sparse_dijkstra, 256);
+BENCHMARK_TEMPLATE(bm_topo_sparse_dijkstra, 4096);
+BENCHMARK_TEMPLATE(bm_topo_sparse_build, 16);
+BENCHMARK_TEMPLATE(bm_topo_sparse_build, 256);
+BENCHMARK_TEMPLATE(bm_topo_sparse_build, 4096);
+BENCHMARK_TEMPLATE(bm_topo_exit_tree_fire, 16, false);
+BENCHMARK_TEMPLATE(bm_topo_exit_tree_fire, 16, true);
+BENCHMARK_TEMPLATE(bm_topo_exit_tree_fire, 256, false);
+BENCHMARK_TEMPLATE(bm_topo_exit_tree_fire, 256, true);
+BENCHMARK_TEMPLATE(bm_topo_exit_tree_fire, 4096, false);
+BENCHMARK_TEMPLATE(bm_topo_exit_tree_fire, 4096, true);
+
+#endif  // !BENCHMARKS_TOPO_BENCHMARKS_HPP
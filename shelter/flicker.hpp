@@ -21,6 +21,7 @@
 #include "asio.hpp"
 
 #include "shelter/utility.hpp"
+#include "frame_relay.hpp"
 
 namespace flicker {
 using acceptor_t = asio::use_awaitable_t<>::as_default_on_t<asio::ip::tcp::acceptor>;
@@ -49,10 +50,19 @@ public:
         co_await asio::async_write(m_socket, asio::buffer(data));
     }
 
+    auto send(std::uint8_t const* data, std::size_t size) -> asio::awaitable<void> {
+        co_await asio::async_write(m_socket, asio::buffer(data, size));
+    }
+
     auto read() -> asio::awaitable<buffer_t> {
         co_await m_socket.async_read_some(asio::buffer(m_data_in));
         co_return m_data_in;
     }
+    // Read whatever is available, the bytes are in data() until the next read.
+    auto read_some() -> asio::awaitable<std::size_t> {
+        co_return co_await m_socket.async_read_some(asio::buffer(m_data_in));
+    }
+    auto data() const -> std::uint8_t const* { return reinterpret_cast<std::uint8_t const*>(m_data_in.data()); }
     auto is_connected() const -> bool { return m_socket.is_open(); }
 
 private:
@@ -101,6 +111,8 @@ public:
         if (m_thread.joinable()) m_thread.join();
     }
     auto is_running() const -> bool { return m_is_running; }
+    // Frames received by the network thread, call from a single consumer thread.
+    auto poll(sky::mcp& frame) -> bool { return m_frames.try_deq(frame); }
 
 private:
     auto listener() -> asio::awaitable<void> {
@@ -117,10 +129,13 @@ private:
     }
 
     auto receive(trench_ref_t conn) -> asio::awaitable<void> {
+        // TCP is a byte stream, frames can arrive split or several at the time
+        sky::mcp_deframer deframer{};
         try {
             while (true) {
-                auto const data = co_await conn->read();
-                co_await conn->send(data);
+                auto const size = co_await conn->read_some();
+                (void)relay_frames(deframer, m_frames, conn->data(), size);  // Dropped when the consumer falls behind
+                co_await conn->send(conn->data(), size);
             }
         } catch (asio::system_error const& e) {
             fmt::print("{}\n", e.what());
@@ -133,6 +148,8 @@ private:
     std::atomic<bool> m_is_running{false};
     std::thread       m_thread{};
     std::vector<trench_ref_t> m_trenchs{};
+    // Every receive coroutine runs on m_thread, that is the only producer
+    frame_queue_t m_frames{};
 };
 } // namespace flicker
 
@@ -0,0 +1,46 @@
+/**
+ * @file   frame_relay.hpp
+ * @author Pratchaya Khansomboon (me@mononerv.dev)
+ * @brief  Hand MCP frames found in a byte stream to a consumer thread.
+ * @date   2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ */
+#ifndef SHELTER_FRAME_RELAY_HPP
+#define SHELTER_FRAME_RELAY_HPP
+#include <cstdint>
+#include <cstddef>
+
+#include "deframer.hpp"
+#include "spsc_queue.hpp"
+
+namespace flicker {
+using frame_queue_t = sky::spsc_queue<sky::mcp, 256>;
+
+/**
+ * @brief Feed bytes read from one connection, every complete frame is pushed to the queue.
+ *        Keep one deframer per connection, TCP can split a frame over several reads.
+ *        Only the network thread may call this, it is the single producer of the queue.
+ *
+ * @return Number of frames dropped because the consumer fell behind.
+ */
+inline auto relay_frames(sky::mcp_deframer& deframer, frame_queue_t& queue,
+                         std::uint8_t const* data, std::size_t size) -> std::size_t {
+    std::size_t dropped = 0;
+    deframer.push(data, size, [&queue, &dropped](sky::mcp_view const& frame) {
+        if (!queue.try_enq(frame.to_mcp())) ++dropped;
+    });
+    return dropped;
+}
+
+/**
+ * @brief Encode a frame taken from the queue back into the wire format.
+ */
+inline auto encode_frame(sky::mcp_wire_t& wire, sky::mcp const& frame) -> void {
+    sky::mcp_buffer_t buffer{};
+    sky::mcp_make_buffer(buffer, frame);
+    sky::mcp_make_wire(wire, buffer);
+}
+} // namespace flicker
+
+#endif  // SHELTER_FRAME_RELAY_HPP
@@ -0,0 +1,97 @@
+/**
+ * @file   address_map.hpp
+ * @author Pratchaya Khansomboon (me@mononerv.dev)
+ * @brief  Fixed capacity address table with constant time address to index lookup.
+ * @date   2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ */
+#ifndef SKY_ADDRESS_MAP_HPP
+#define SKY_ADDRESS_MAP_HPP
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+#include "mcp.hpp"
+
+namespace sky {
+/**
+ * @brief Addresses in insertion order, so the index of an address never changes and can be
+ *        used as its topology node. Lookups go through an open addressing hash table on the
+ *        24 bit address with linear probing, at most half full, no heap.
+ *
+ *        The 0 address means no address in mcp and is never stored.
+ */
+template <std::size_t CAPACITY>
+class address_map {
+    static_assert(CAPACITY > 0 && CAPACITY < 0xFFFF, "index + 1 must fit a slot");
+
+    static constexpr auto slots_for(std::size_t capacity) -> std::size_t {
+        std::size_t slots = 1;
+        while (slots < capacity * 2) slots <<= 1;
+        return slots;
+    }
+    static constexpr std::size_t slot_count = slots_for(CAPACITY);
+
+public:
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    // Index of the address, npos when it is not in the table.
+    [[nodiscard]] auto find(std::uint32_t key) const noexcept -> std::size_t {
+        if (key == 0) return npos;
+        for (auto slot = hash(key);; slot = (slot + 1) & (slot_count - 1)) {
+            auto const entry = m_slots[slot];
+            if (entry == 0) return npos;
+            if (m_keys[entry - 1] == key) return entry - 1u;
+        }
+    }
+    [[nodiscard]] auto find(address_t const& address) const noexcept -> std::size_t {
+        return find(mcp_address_to_u32(address));
+    }
+
+    /**
+     * @brief Add the address at the end if it is new.
+     * @return Index of the address, npos for the 0 address or when the table is full.
+     */
+    auto insert(address_t const& address) noexcept -> std::size_t {
+        auto const key = mcp_address_to_u32(address);
+        if (key == 0) return npos;
+        auto slot = hash(key);
+        for (; m_slots[slot] != 0; slot = (slot + 1) & (slot_count - 1)) {
+            if (m_keys[m_slots[slot] - 1] == key) return m_slots[slot] - 1u;
+        }
+        if (m_size == CAPACITY) return npos;
+        m_keys[m_size] = key;
+        std::memcpy(m_addresses[m_size], address, address_size);
+        m_slots[slot] = static_cast<std::uint16_t>(++m_size);
+        return m_size - 1;
+    }
+
+    // Address at index, the 0 address past size().
+    [[nodiscard]] auto operator[](std::size_t index) const noexcept -> address_t const& {
+        return m_addresses[index];
+    }
+
+    [[nodiscard]] auto size() const noexcept -> std::size_t { return m_size; }
+    [[nodiscard]] auto capacity() const noexcept -> std::size_t { return CAPACITY; }
+
+    auto clear() noexcept -> void {
+        for (auto& slot : m_slots) slot = 0;
+        for (auto& address : m_addresses) std::memset(address, 0, address_size);
+        m_size = 0;
+    }
+
+private:
+    static auto hash(std::uint32_t key) noexcept -> std::size_t {
+        return static_cast<std::size_t>((key * 2654435761u) >> 8) & (slot_count - 1);  // Knuth multiplicative hash
+    }
+
+private:
+    std::uint16_t m_slots[slot_count]{};  // Index + 1, 0 is empty
+    std::uint32_t m_keys[CAPACITY]{};
+    address_t     m_addresses[CAPACITY]{};
+    std::size_t   m_size = 0;
+};
+} // namespace sky
+
+#endif  // !SKY_ADDRESS_MAP_HPP
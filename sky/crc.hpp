@@ -0,0 +1,218 @@
+/**
+ * @file   crc.hpp
+ * @author Pratchaya Khansomboon (me@mononerv.dev)
+ * @brief  CRC-8 engine with bitwise, table-driven and slicing-by-N kernels, and a CRC-16.
+ * @date   2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ */
+#ifndef SKY_CRC_HPP
+#define SKY_CRC_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+namespace sky {
+/**
+ * @brief Reference CRC-8 implementation, shifts one bit at the time.
+ *
+ * @param buffer Data to compute the checksum over.
+ * @param size   Number of bytes in buffer.
+ * @param crc    Register value to continue from, 0x00 when starting a new message.
+ */
+template <std::uint8_t POLY = 0x07>
+inline constexpr auto crc_8_bitwise(std::uint8_t const* buffer, std::size_t size, std::uint8_t crc = 0x00) -> std::uint8_t {
+    constexpr std::uint8_t poly = POLY;
+    std::uint8_t reg = crc;
+    for (std::size_t i = 0; i < size; ++i) {
+        reg = reg ^ buffer[i];
+        for (std::uint8_t j = 0; j < 8; ++j) {
+            if (reg & 0x80)
+                reg = std::uint8_t(reg << 1) ^ poly;
+            else
+                reg = std::uint8_t(reg << 1);
+        }
+    }
+    return reg;
+}
+
+constexpr std::size_t crc_8_slices = 8;
+
+/**
+ * @brief Lookup tables for one polynomial.
+ *        table[k][b] is the register after feeding byte b followed by k zero bytes,
+ *        table[0] is the classic 256 entry byte-at-a-time table.
+ */
+struct crc_8_table_t {
+    std::uint8_t table[crc_8_slices][256];
+};
+
+template <std::uint8_t POLY>
+inline constexpr auto crc_8_make_table() -> crc_8_table_t {
+    crc_8_table_t lut{};
+    for (std::size_t b = 0; b < 256; ++b) {
+        auto const byte = static_cast<std::uint8_t>(b);
+        lut.table[0][b] = crc_8_bitwise<POLY>(&byte, 1);
+    }
+    for (std::size_t k = 1; k < crc_8_slices; ++k) {
+        for (std::size_t b = 0; b < 256; ++b)
+            lut.table[k][b] = lut.table[0][lut.table[k - 1][b]];
+    }
+    return lut;
+}
+
+// Generated at compile time, one instance per polynomial in use.
+template <std::uint8_t POLY>
+inline constexpr crc_8_table_t crc_8_lut = crc_8_make_table<POLY>();
+
+template <std::uint8_t POLY = 0x07>
+inline constexpr auto crc_8_table(std::uint8_t const* buffer, std::size_t size, std::uint8_t crc = 0x00) -> std::uint8_t {
+    auto const& t = crc_8_lut<POLY>.table[0];
+    for (std::size_t i = 0; i < size; ++i)
+        crc = t[crc ^ buffer[i]];
+    return crc;
+}
+
+template <std::uint8_t POLY = 0x07>
+inline constexpr auto crc_8_slice_4(std::uint8_t const* buffer, std::size_t size, std::uint8_t crc = 0x00) -> std::uint8_t {
+    auto const& t = crc_8_lut<POLY>.table;
+    for (; size >= 4; size -= 4, buffer += 4) {
+        crc = t[3][crc ^ buffer[0]] ^ t[2][buffer[1]] ^ t[1][buffer[2]] ^ t[0][buffer[3]];
+    }
+    return crc_8_table<POLY>(buffer, size, crc);
+}
+
+template <std::uint8_t POLY = 0x07>
+inline constexpr auto crc_8_slice_8(std::uint8_t const* buffer, std::size_t size, std::uint8_t crc = 0x00) -> std::uint8_t {
+    auto const& t = crc_8_lut<POLY>.table;
+    for (; size >= 8; size -= 8, buffer += 8) {
+        crc = t[7][crc ^ buffer[0]] ^ t[6][buffer[1]] ^ t[5][buffer[2]] ^ t[4][buffer[3]]
+            ^ t[3][buffer[4]]       ^ t[2][buffer[5]] ^ t[1][buffer[6]] ^ t[0][buffer[7]];
+    }
+    return crc_8_slice_4<POLY>(buffer, size, crc);
+}
+
+enum class crc_kernel : std::uint8_t {
+    bitwise,
+    table,
+    slice_4,
+    slice_8,
+};
+
+/**
+ * @brief Pick the fastest kernel for a buffer of given size. The slicing kernels
+ *        pay for touching more table memory, so they only win on longer buffers.
+ *        Thresholds come from the crc benchmarks in benchmarks/crc_benchmarks.hpp.
+ */
+inline constexpr auto crc_8_select_kernel(std::size_t size) noexcept -> crc_kernel {
+    if (size < 8)  return crc_kernel::table;
+    if (size < 32) return crc_kernel::slice_4;
+    return crc_kernel::slice_8;
+}
+
+template <std::uint8_t POLY = 0x07>
+inline constexpr auto crc_8_compute(crc_kernel kernel, std::uint8_t const* buffer, std::size_t size, std::uint8_t crc = 0x00) -> std::uint8_t {
+    switch (kernel) {
+    case crc_kernel::bitwise: return crc_8_bitwise<POLY>(buffer, size, crc);
+    case crc_kernel::table:   return crc_8_table<POLY>(buffer, size, crc);
+    case crc_kernel::slice_4: return crc_8_slice_4<POLY>(buffer, size, crc);
+    case crc_kernel::slice_8: return crc_8_slice_8<POLY>(buffer, size, crc);
+    }
+    return crc_8_table<POLY>(buffer, size, crc);
+}
+
+template <std::uint8_t POLY = 0x07>
+inline constexpr auto crc_8(std::uint8_t const* buffer, std::size_t size) -> std::uint8_t {
+    return crc_8_compute<POLY>(crc_8_select_kernel(size), buffer, size);
+}
+
+/**
+ * @brief Advance the register over a run of zero bytes.
+ */
+template <std::uint8_t POLY = 0x07>
+inline constexpr auto crc_8_zero_extend(std::uint8_t crc, std::size_t zeros) -> std::uint8_t {
+    auto const& t = crc_8_lut<POLY>.table[0];
+    for (std::size_t i = 0; i < zeros; ++i)
+        crc = t[crc];
+    return crc;
+}
+
+template <std::uint8_t POLY, std::size_t ZEROS>
+inline constexpr auto crc_8_make_shift_table() -> std::array<std::uint8_t, 256> {
+    std::array<std::uint8_t, 256> table{};
+    for (std::size_t b = 0; b < 256; ++b)
+        table[b] = crc_8_zero_extend<POLY>(static_cast<std::uint8_t>(b), ZEROS);
+    return table;
+}
+
+// Same as crc_8_zero_extend with a fixed run length, in a single lookup.
+template <std::uint8_t POLY, std::size_t ZEROS>
+inline constexpr std::array<std::uint8_t, 256> crc_8_shift_lut = crc_8_make_shift_table<POLY, ZEROS>();
+
+/**
+ * @brief Update the CRC of a message when a field changes, without rescanning the message.
+ *        The CRC has no initial value or final xor, so it is linear:
+ *        crc(a ^ b) == crc(a) ^ crc(b). Only the difference of the field, followed by the
+ *        bytes after it, has to be run through the register.
+ *
+ * @param crc       CRC of the message before the change.
+ * @param old_bytes Previous content of the field.
+ * @param new_bytes New content of the field.
+ * @param size      Size of the field in bytes.
+ * @param trailing  Number of message bytes after the field.
+ */
+template <std::uint8_t POLY = 0x07>
+inline constexpr auto crc_8_update(std::uint8_t crc, std::uint8_t const* old_bytes, std::uint8_t const* new_bytes,
+                                   std::size_t size, std::size_t trailing) -> std::uint8_t {
+    auto const& t = crc_8_lut<POLY>.table[0];
+    std::uint8_t delta = 0x00;
+    for (std::size_t i = 0; i < size; ++i)
+        delta = t[delta ^ old_bytes[i] ^ new_bytes[i]];
+    return crc ^ crc_8_zero_extend<POLY>(delta, trailing);
+}
+
+/**
+ * @brief Reference CRC-16, most significant bit first like the CRC-8 above. The defaults are
+ *        CRC-16/CCITT-FALSE, the register starts at 0xFFFF so runs of zero bytes do not pass.
+ *
+ * @param crc Register value to continue from, 0xFFFF when starting a new message.
+ */
+template <std::uint16_t POLY = 0x1021>
+inline constexpr auto crc_16_bitwise(std::uint8_t const* buffer, std::size_t size, std::uint16_t crc = 0xFFFF) -> std::uint16_t {
+    std::uint16_t reg = crc;
+    for (std::size_t i = 0; i < size; ++i) {
+        reg = static_cast<std::uint16_t>(reg ^ (buffer[i] << 8));
+        for (std::uint8_t j = 0; j < 8; ++j) {
+            if (reg & 0x8000)
+                reg = static_cast<std::uint16_t>(reg << 1) ^ POLY;
+            else
+                reg = static_cast<std::uint16_t>(reg << 1);
+        }
+    }
+    return reg;
+}
+
+template <std::uint16_t POLY>
+inline constexpr auto crc_16_make_table() -> std::array<std::uint16_t, 256> {
+    std::array<std::uint16_t, 256> table{};
+    for (std::size_t b = 0; b < 256; ++b) {
+        auto const byte = static_cast<std::uint8_t>(b);
+        table[b] = crc_16_bitwise<POLY>(&byte, 1, 0x0000);
+    }
+    return table;
+}
+
+template <std::uint16_t POLY>
+inline constexpr std::array<std::uint16_t, 256> crc_16_lut = crc_16_make_table<POLY>();
+
+template <std::uint16_t POLY = 0x1021>
+inline constexpr auto crc_16_table(std::uint8_t const* buffer, std::size_t size, std::uint16_t crc = 0xFFFF) -> std::uint16_t {
+    auto const& t = crc_16_lut<POLY>;
+    for (std::size_t i = 0; i < size; ++i)
+        crc = static_cast<std::uint16_t>(crc << 8) ^ t[static_cast<std::uint8_t>(crc >> 8) ^ buffer[i]];
+    return crc;
+}
+} // namespace sky
+
+#endif  // !SKY_CRC_HPP
@@ -0,0 +1,81 @@
+/**
+ * @file   dedup.hpp
+ * @author Pratchaya Khansomboon (me@mononerv.dev)
+ * @brief  Recently seen cache for dropping duplicate flooded frames.
+ * @date   2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ */
+#ifndef SKY_DEDUP_HPP
+#define SKY_DEDUP_HPP
+#include <cstdint>
+#include <cstddef>
+
+#include "mcp.hpp"
+
+namespace sky {
+struct mcp_dedup_stats {
+    std::uint32_t accepted   = 0;  // First copy of a frame, passed on for processing
+    std::uint32_t duplicates = 0;  // Copies dropped before any processing
+};
+
+/**
+ * @brief Fixed size cache of recently seen (source, sequence) pairs.
+ *        Direct mapped, a lookup is one hash and one compare. A collision evicts the
+ *        older entry, which at worst lets a duplicate through, never drops a new frame.
+ *
+ *        Entries expire after SIZE newer frames. A source needs 256 new frames to wrap its
+ *        8 bit sequence, keeping SIZE below that means a wrapped sequence is never
+ *        mistaken for a duplicate.
+ */
+template <std::size_t SIZE = 64>
+class mcp_dedup_cache {
+    static_assert(SIZE > 0 && (SIZE & (SIZE - 1)) == 0, "SIZE must be a power of two");
+    static_assert(SIZE <= 128, "SIZE must stay below the sequence range");
+
+public:
+    /**
+     * @brief Record the frame and check if it was seen before.
+     * @return true if the frame is a duplicate and should be dropped.
+     */
+    auto is_duplicate(mcp_view const& frame) noexcept -> bool {
+        auto const key  = make_key(frame);
+        auto& entry = m_entries[index(key)];
+        if (entry.stamp != 0 && entry.key == key && m_clock - entry.stamp < SIZE) {
+            ++m_stats.duplicates;
+            return true;
+        }
+        entry.key   = key;
+        entry.stamp = ++m_clock;
+        ++m_stats.accepted;
+        return false;
+    }
+
+    auto clear() noexcept -> void {
+        for (auto& entry : m_entries) entry = {};
+        m_clock = 0;
+    }
+    [[nodiscard]] auto stats() const noexcept -> mcp_dedup_stats const& { return m_stats; }
+    [[nodiscard]] auto capacity() const noexcept -> std::size_t { return SIZE; }
+
+private:
+    struct entry_t {
+        std::uint32_t key   = 0;
+        std::uint32_t stamp = 0;  // Value of m_clock when inserted, 0 is empty
+    };
+
+    static auto make_key(mcp_view const& frame) noexcept -> std::uint32_t {
+        return mcp_address_to_u32(frame.source()) | static_cast<std::uint32_t>(frame.sequence()) << 24;
+    }
+    static auto index(std::uint32_t key) noexcept -> std::size_t {
+        return static_cast<std::size_t>((key * 2654435761u) >> 16) & (SIZE - 1);  // Knuth multiplicative hash
+    }
+
+private:
+    entry_t         m_entries[SIZE]{};
+    std::uint32_t   m_clock = 0;
+    mcp_dedup_stats m_stats{};
+};
+} // namespace sky
+
+#endif  // !SKY_DEDUP_HPP
@@ -0,0 +1,119 @@
+/**
+ * @file   deframer.hpp
+ * @author Pratchaya Khansomboon (me@mononerv.dev)
+ * @brief  Split a byte stream into Message Control Protocol frames.
+ * @date   2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ */
+#ifndef SKY_DEFRAMER_HPP
+#define SKY_DEFRAMER_HPP
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+#include "mcp.hpp"
+
+namespace sky {
+struct mcp_deframer_stats {
+    std::uint32_t frames        = 0;  // Complete frames emitted
+    std::uint32_t resyncs       = 0;  // Times the stream lost frame alignment
+    std::uint32_t dropped_bytes = 0;  // Bytes skipped while searching for a frame boundary
+};
+
+/**
+ * @brief Streaming deframer for any byte source, e.g. SoftwareSerial reads or a TCP socket.
+ *        Frames are sent with mcp_make_wire and have no sync byte or length header, the
+ *        boundary is found with the checks: a window of mcp_wire_size bytes with a known
+ *        type, a valid CRC-8 and a valid CRC-16 trailer is a frame. When the window is not a
+ *        frame the oldest byte is dropped and the search continues one byte later. Chunks can
+ *        have any size, frames split across chunks or several frames in one chunk are handled
+ *        the same way.
+ *
+ *        Every byte after a lost or cut frame starts a window made of the ends of two real
+ *        frames. The type and CRC-8 let about one in 11000 of those through, the trailer
+ *        another one in 65536.
+ */
+class mcp_deframer {
+public:
+    /**
+     * @param type_limit Frames with type >= type_limit are treated as noise, this rejects
+     *                   most shifted windows before any CRC is computed.
+     */
+    explicit mcp_deframer(std::uint8_t type_limit = 0xFF) noexcept : m_type_limit(type_limit) {}
+
+    /**
+     * @brief Feed a chunk of bytes, fn(mcp_view) is called for every complete frame.
+     *        The view is only valid during the call.
+     */
+    template <typename Fn>
+    auto push(std::uint8_t const* data, std::size_t size, Fn&& fn) -> void {
+        while (size > 0) {
+            // Fast path, aligned with a whole frame in the input: validate in place
+            if (m_size == 0 && size >= mcp_wire_size) {
+                if (is_frame(data)) {
+                    emit(data, fn);
+                    data += mcp_wire_size;
+                    size -= mcp_wire_size;
+                } else {
+                    drop(1);
+                    ++data;
+                    --size;
+                }
+                continue;
+            }
+
+            auto const count = size < mcp_wire_size - m_size ? size : mcp_wire_size - m_size;
+            std::memcpy(m_buffer + m_size, data, count);
+            m_size += count;
+            data   += count;
+            size   -= count;
+            if (m_size < mcp_wire_size) break;
+
+            if (is_frame(m_buffer)) {
+                emit(m_buffer, fn);
+                m_size = 0;
+            } else {
+                // Slide the window one byte and retry with the bytes already buffered
+                drop(1);
+                std::memmove(m_buffer, m_buffer + 1, --m_size);
+            }
+        }
+    }
+
+    auto reset() noexcept -> void {
+        m_size    = 0;
+        m_aligned = true;
+    }
+    [[nodiscard]] auto buffered() const noexcept -> std::size_t { return m_size; }
+    [[nodiscard]] auto stats() const noexcept -> mcp_deframer_stats const& { return m_stats; }
+
+private:
+    [[nodiscard]] auto is_frame(std::uint8_t const* data) const noexcept -> bool {
+        mcp_view const frame{data};
+        return frame.type() < m_type_limit && frame.check_crc() && mcp_check_wire(data);
+    }
+
+    template <typename Fn>
+    auto emit(std::uint8_t const* data, Fn& fn) -> void {
+        ++m_stats.frames;
+        m_aligned = true;
+        fn(mcp_view{data});
+    }
+
+    auto drop(std::uint32_t count) noexcept -> void {
+        if (m_aligned) ++m_stats.resyncs;
+        m_aligned = false;
+        m_stats.dropped_bytes += count;
+    }
+
+private:
+    mcp_wire_t         m_buffer{};
+    std::size_t        m_size = 0;
+    std::uint8_t       m_type_limit;
+    bool               m_aligned = true;
+    mcp_deframer_stats m_stats{};
+};
+} // namespace sky
+
+#endif  // !SKY_DEFRAMER_HPP
@@ -0,0 +1,295 @@
+/**
+ * @file   exit_tree.hpp
+ * @author Pratchaya Khansomboon (me@mononerv.dev)
+ * @brief  Shortest path tree towards the nearest exit, repaired in place when the topology changes.
+ * @date   2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ */
+#ifndef SKY_EXIT_TREE_HPP
+#define SKY_EXIT_TREE_HPP
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <functional>
+
+#include "sparse_topo.hpp"
+
+namespace sky {
+/**
+ * @brief Every node's next hop and distance to its nearest exit over a sparse_topo with
+ *        undirected links. build() runs one Dijkstra with every exit seeded at distance 0,
+ *        so several exits cost the same as one. After that the changes go through the tree
+ *        so only the affected nodes are recomputed:
+ *
+ *        - A removed node or link, or a more expensive link, only invalidates the nodes whose
+ *          way out went through it. They are seeded from their unaffected neighbours and
+ *          Dijkstra runs over them alone, the rest of the tree can not get any shorter.
+ *        - An added or cheaper link only propagates from its end points while it improves.
+ *
+ *        After every call changed() lists the nodes whose next hop differs from before.
+ */
+template <std::size_t NODES, std::size_t EDGES>
+class exit_tree {
+    static_assert(NODES < 0xFFFF, "topo_index_t must have room for none");
+
+public:
+    using topo_t = sparse_topo<NODES, EDGES>;
+    static constexpr topo_index_t none = 0xFFFF;
+
+    auto build(topo_t const& topology, std::uint32_t exit) -> void {
+        build(topology, &exit, 1);
+    }
+    // Exits out of range or given twice are skipped.
+    auto build(topo_t const& topology, std::uint32_t const* exits, std::size_t count) -> void {
+        begin();
+        for (std::size_t i = 0; i < NODES; ++i) {
+            touch(i);
+            m_distance[i] = unreached;
+            m_next[i]     = none;
+            m_nearest[i]  = none;
+            m_is_exit[i]  = false;
+        }
+        m_exit_count = 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            if (exits[i] >= NODES || m_is_exit[exits[i]]) continue;
+            m_is_exit[exits[i]] = true;
+            m_exits[m_exit_count++] = static_cast<topo_index_t>(exits[i]);
+            if (!topology.fire[exits[i]]) seed_exit(exits[i]);
+        }
+        propagate(topology);
+        end();
+    }
+
+    // Put the node in firemode in the topology and repair the tree.
+    auto set_node_firemode(topo_t& topology, std::uint32_t node_id) -> void {
+        begin();
+        if (node_id < NODES) {
+            invalidate(topology, node_id);
+            sparse_topo_set_node_firemode(topology, node_id);
+            repair(topology);
+        }
+        end();
+    }
+
+    // Take the node out of firemode, its links come back through set_node_link_cost.
+    auto clear_node_firemode(topo_t& topology, std::uint32_t node_id) -> void {
+        begin();
+        if (node_id < NODES && topology.fire[node_id]) {
+            sparse_topo_clear_node_firemode(topology, node_id);
+            if (m_is_exit[node_id]) {
+                touch(node_id);
+                seed_exit(node_id);
+                propagate(topology);
+            }
+        }
+        end();
+    }
+
+    /**
+     * @brief Set the link cost in the topology like sparse_topo_set_node_link_cost and repair the tree.
+     * @return false if the topology has no room for the link, nothing changes then.
+     */
+    auto set_node_link_cost(topo_t& topology, std::uint32_t node_id, std::uint32_t end_node_id, std::int8_t cost) -> bool {
+        begin();
+        if (node_id >= NODES || end_node_id >= NODES || node_id == end_node_id) {
+            end();
+            return false;
+        }
+        auto const e = detail::sparse_topo_find(topology, node_id, end_node_id);
+        auto const exists = e != topology.row[NODES];
+        auto const old_cost = exists ? topology.cost[e] : std::int8_t{0};
+
+        bool ok = true;
+        if (exists && (cost <= 0 || cost > old_cost)) {
+            // Longer or gone, invalidate whoever went through the link
+            if (m_next[node_id] == end_node_id) invalidate(topology, node_id);
+            if (m_next[end_node_id] == node_id) invalidate(topology, end_node_id);
+            sparse_topo_set_node_link_cost(topology, node_id, end_node_id, cost);
+            repair(topology);
+        } else if (cost > 0 && (!exists || cost < old_cost)) {
+            ok = sparse_topo_set_node_link_cost(topology, node_id, end_node_id, cost);
+            if (ok) {
+                relax(node_id, end_node_id, cost, topology);
+                relax(end_node_id, node_id, cost, topology);
+                propagate(topology);
+            }
+        }
+        end();
+        return ok;
+    }
+
+    [[nodiscard]] auto exits() const noexcept -> topo_index_t const* { return m_exits; }
+    [[nodiscard]] auto exit_count() const noexcept -> std::size_t { return m_exit_count; }
+    [[nodiscard]] auto is_exit(std::uint32_t node_id) const noexcept -> bool { return m_is_exit[node_id]; }
+    // Exit the node is routed to, none when there is no way out.
+    [[nodiscard]] auto nearest_exit(std::uint32_t node_id) const noexcept -> topo_index_t { return m_nearest[node_id]; }
+    // Next node towards the nearest exit, an exit points to itself, none when there is no way out.
+    [[nodiscard]] auto next(std::uint32_t node_id) const noexcept -> topo_index_t { return m_next[node_id]; }
+    // Cost to the nearest exit, -1 when there is no way out.
+    [[nodiscard]] auto distance(std::uint32_t node_id) const noexcept -> std::int32_t {
+        return m_distance[node_id] == unreached ? -1 : m_distance[node_id];
+    }
+
+    /**
+     * @brief Follow the tree from src to its nearest exit.
+     * @return Number of nodes written to out, 0 if there is no way out or it does not fit.
+     */
+    auto path(std::uint32_t src, std::uint32_t* out, std::size_t out_size) const -> std::size_t {
+        if (src >= NODES) return 0;
+        std::size_t length = 0;
+        for (auto node = src; length < out_size && m_next[node] != none; node = m_next[node]) {
+            out[length++] = node;
+            if (m_is_exit[node]) return length;
+        }
+        return 0;
+    }
+
+    [[nodiscard]] auto changed() const noexcept -> topo_index_t const* { return m_changed; }
+    [[nodiscard]] auto changed_count() const noexcept -> std::size_t { return m_changed_count; }
+
+private:
+    struct item {
+        std::int32_t distance;
+        topo_index_t node;
+        auto operator>(item const& other) const -> bool { return distance > other.distance; }
+    };
+    static constexpr std::int32_t unreached = INT32_MAX;
+
+    auto begin() noexcept -> void {
+        m_touched_count = 0;
+        m_heap_size = 0;
+    }
+    // Remember the next hop before the first change in this call.
+    auto touch(std::size_t node) noexcept -> void {
+        if (m_touched[node]) return;
+        m_touched[node] = true;
+        m_old_next[node] = m_next[node];
+        m_touched_list[m_touched_count++] = static_cast<topo_index_t>(node);
+    }
+    auto end() noexcept -> void {
+        m_changed_count = 0;
+        for (std::size_t i = 0; i < m_touched_count; ++i) {
+            auto const node = m_touched_list[i];
+            m_touched[node] = false;
+            if (m_next[node] != m_old_next[node]) m_changed[m_changed_count++] = node;
+        }
+    }
+
+    auto seed_exit(std::size_t node) -> void {
+        m_distance[node] = 0;
+        m_next[node]     = static_cast<topo_index_t>(node);
+        m_nearest[node]  = static_cast<topo_index_t>(node);
+        push(0, static_cast<topo_index_t>(node));
+    }
+
+    auto push(std::int32_t distance, topo_index_t node) -> void {
+        m_heap[m_heap_size++] = {distance, node};
+        std::push_heap(m_heap, m_heap + m_heap_size, std::greater<item>{});
+    }
+
+    // Mark the subtree hanging under root, their distances are unknown until repair().
+    auto invalidate(topo_t const& topology, std::size_t root) -> void {
+        if (m_next[root] == none || m_invalid[root]) return;
+        std::size_t top = m_affected_count;
+        m_affected[m_affected_count++] = static_cast<topo_index_t>(root);
+        m_invalid[root] = true;
+        while (top < m_affected_count) {
+            auto const node = m_affected[top++];
+            for (auto e = topology.row[node]; e < topology.row[node + 1]; ++e) {
+                auto const child = topology.column[e];
+                if (m_invalid[child] || m_is_exit[child] || m_next[child] != node) continue;
+                m_invalid[child] = true;
+                m_affected[m_affected_count++] = child;
+            }
+        }
+    }
+
+    // Seed the invalidated nodes from their valid neighbours and finish with Dijkstra.
+    auto repair(topo_t const& topology) -> void {
+        for (std::size_t i = 0; i < m_affected_count; ++i) {
+            auto const node = m_affected[i];
+            touch(node);
+            m_distance[node] = unreached;
+            m_next[node]     = none;
+            m_nearest[node]  = none;
+        }
+        for (std::size_t i = 0; i < m_affected_count; ++i) {
+            auto const node = m_affected[i];
+            if (topology.fire[node]) continue;
+            if (m_is_exit[node]) {
+                seed_exit(node);
+                continue;
+            }
+            for (auto e = topology.row[node]; e < topology.row[node + 1]; ++e) {
+                auto const other = topology.column[e];
+                if (m_invalid[other] || m_distance[other] == unreached) continue;
+                auto const new_distance = m_distance[other] + topology.cost[e];
+                if (new_distance < m_distance[node]) {
+                    m_distance[node] = new_distance;
+                    m_next[node]     = other;
+                    m_nearest[node]  = m_nearest[other];
+                }
+            }
+            if (m_distance[node] != unreached) push(m_distance[node], node);
+        }
+        for (std::size_t i = 0; i < m_affected_count; ++i) m_invalid[m_affected[i]] = false;
+        m_affected_count = 0;
+        propagate(topology);
+    }
+
+    // node -> other with the given cost, other is already final.
+    auto relax(std::size_t node, std::size_t other, std::int8_t cost, topo_t const& topology) -> void {
+        if (topology.fire[node] || m_is_exit[node] || m_distance[other] == unreached) return;
+        auto const new_distance = m_distance[other] + cost;
+        if (new_distance >= m_distance[node]) return;
+        touch(node);
+        m_distance[node] = new_distance;
+        m_next[node]     = static_cast<topo_index_t>(other);
+        m_nearest[node]  = m_nearest[other];
+        push(new_distance, static_cast<topo_index_t>(node));
+    }
+
+    auto propagate(topo_t const& topology) -> void {
+        while (m_heap_size > 0) {
+            std::pop_heap(m_heap, m_heap + m_heap_size, std::greater<item>{});
+            auto const current = m_heap[--m_heap_size];
+            if (current.distance != m_distance[current.node]) continue;  // Stale entry
+            for (auto e = topology.row[current.node]; e < topology.row[current.node + 1]; ++e) {
+                auto const other = topology.column[e];
+                if (m_is_exit[other] || topology.fire[other]) continue;
+                auto const new_distance = current.distance + topology.cost[e];
+                if (new_distance >= m_distance[other]) continue;
+                touch(other);
+                m_distance[other] = new_distance;
+                m_next[other]     = current.node;
+                m_nearest[other]  = m_nearest[current.node];
+                push(new_distance, other);
+            }
+        }
+    }
+
+private:
+    topo_index_t m_exits[NODES]{};
+    std::size_t  m_exit_count = 0;
+    bool         m_is_exit[NODES]{};
+    std::int32_t m_distance[NODES]{};
+    topo_index_t m_next[NODES]{};
+    topo_index_t m_nearest[NODES]{};
+
+    // Bookkeeping for one call
+    item         m_heap[EDGES + NODES]{};
+    std::size_t  m_heap_size = 0;
+    topo_index_t m_affected[NODES]{};
+    std::size_t  m_affected_count = 0;
+    bool         m_invalid[NODES]{};
+    topo_index_t m_old_next[NODES]{};
+    bool         m_touched[NODES]{};
+    topo_index_t m_touched_list[NODES]{};
+    std::size_t  m_touched_count = 0;
+    topo_index_t m_changed[NODES]{};
+    std::size_t  m_changed_count = 0;
+};
+} // namespace sky
+
+#endif  // !SKY_EXIT_TREE_HPP
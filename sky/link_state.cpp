@@ -0,0 +1,58 @@
+/**
+ * @file   link_state.cpp
+ * @author Pratchaya Khansomboon (me@mononerv.dev)
+ * @brief  Versioned link-state table for topology gossip.
+ * @date   2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ */
+#include "link_state.hpp"
+
+namespace sky {
+static_assert(3 + link_state_links * address_size <= payload_size, "advert must fit a payload");
+static_assert(link_state_digests * (address_size + 2) <= payload_size, "digest must fit a payload");
+
+auto link_state_encode_advert(payload_t& payload, link_state_advert const& advert) noexcept -> void {
+    std::memset(payload, 0, payload_size);
+    payload[0] = static_cast<std::uint8_t>(advert.version);
+    payload[1] = static_cast<std::uint8_t>(advert.version >> 8);
+    payload[2] = advert.flags;
+    for (std::size_t i = 0; i < link_state_links; ++i) {
+        std::memcpy(payload + 3 + i * address_size, advert.links[i], address_size);
+    }
+}
+
+auto link_state_decode_advert(address_t const& origin, payload_t const& payload) noexcept -> link_state_advert {
+    link_state_advert advert{};
+    std::memcpy(advert.origin, origin, address_size);
+    advert.version = static_cast<std::uint16_t>(payload[0] | payload[1] << 8);
+    advert.flags   = payload[2];
+    for (std::size_t i = 0; i < link_state_links; ++i) {
+        std::memcpy(advert.links[i], payload + 3 + i * address_size, address_size);
+    }
+    return advert;
+}
+
+auto link_state_encode_digest(payload_t& payload, link_state_digest const* entries, std::size_t count) noexcept -> void {
+    std::memset(payload, 0, payload_size);
+    if (count > link_state_digests) count = link_state_digests;
+    for (std::size_t i = 0; i < count; ++i) {
+        auto const at = payload + i * (address_size + 2);
+        std::memcpy(at, entries[i].origin, address_size);
+        at[address_size]     = static_cast<std::uint8_t>(entries[i].version);
+        at[address_size + 1] = static_cast<std::uint8_t>(entries[i].version >> 8);
+    }
+}
+
+auto link_state_decode_digest(payload_t const& payload, link_state_digest (&out)[link_state_digests]) noexcept -> std::size_t {
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < link_state_digests; ++i) {
+        auto const at = payload + i * (address_size + 2);
+        auto& entry = out[count];
+        std::memcpy(entry.origin, at, address_size);
+        entry.version = static_cast<std::uint16_t>(at[address_size] | at[address_size + 1] << 8);
+        if (mcp_address_to_u32(entry.origin) != 0) ++count;
+    }
+    return count;
+}
+} // namespace sky
@@ -0,0 +1,135 @@
+/**
+ * @file   link_state.hpp
+ * @author Pratchaya Khansomboon (me@mononerv.dev)
+ * @brief  Versioned link-state table for topology gossip.
+ * @date   2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ */
+#ifndef SKY_LINK_STATE_HPP
+#define SKY_LINK_STATE_HPP
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+#include "mcp.hpp"
+#include "address_map.hpp"
+
+namespace sky {
+constexpr std::size_t link_state_links   = 4;  // One neighbour per channel
+constexpr std::size_t link_state_digests = 3;  // Entries in one digest payload
+constexpr std::uint8_t link_state_exit   = 1;  // Advert flag, the origin is an exit
+
+// Neighbours of a node by channel as it advertised them, the 0 address where there is none.
+struct link_state_advert {
+    address_t     origin{};
+    std::uint16_t version = 0;  // Never advertised, stands for unknown
+    std::uint8_t  flags   = 0;
+    address_t     links[link_state_links]{};
+};
+
+// What a digest says about one origin.
+struct link_state_digest {
+    address_t     origin{};
+    std::uint16_t version = 0;
+};
+
+struct link_state_stats {
+    std::uint32_t applied = 0;  // Adverts newer than what was known
+    std::uint32_t stale   = 0;  // Adverts already known or older
+    std::uint32_t full    = 0;  // New origins with no room left
+};
+
+// True when version a came after b, versions wrap around. Every version is newer than unknown.
+constexpr auto link_state_newer(std::uint16_t a, std::uint16_t b) noexcept -> bool {
+    if (b == 0) return a != 0;
+    return a != 0 && static_cast<std::int16_t>(static_cast<std::uint16_t>(a - b)) > 0;
+}
+
+// Advert payload: version little endian, flags, then the links. The origin is the frame source.
+auto link_state_encode_advert(payload_t& payload, link_state_advert const& advert) noexcept -> void;
+auto link_state_decode_advert(address_t const& origin, payload_t const& payload) noexcept -> link_state_advert;
+// Digest payload: up to link_state_digests of origin and version, unused entries are 0.
+auto link_state_encode_digest(payload_t& payload, link_state_digest const* entries, std::size_t count) noexcept -> void;
+// Returns the number of entries read into out.
+auto link_state_decode_digest(payload_t const& payload, link_state_digest (&out)[link_state_digests]) noexcept -> std::size_t;
+
+/**
+ * @brief Latest advert of every origin heard of. A node floods an advert only when its own
+ *        neighbours change, with a version one higher than the last. Receivers keep it and
+ *        pass it on only when it is newer than what they hold, so a change crosses the mesh
+ *        once instead of the whole table being resent all the time.
+ *
+ *        Digests are the slow catch up for adverts that were lost. They list origins and
+ *        versions a few at a time, a neighbour that knows better answers with the advert.
+ */
+template <std::size_t CAPACITY>
+class link_state_table {
+public:
+    static constexpr std::size_t npos = address_map<CAPACITY>::npos;
+
+    /**
+     * @brief Keep the advert if it is newer than the stored one of its origin.
+     * @return Index of the origin when the advert was kept, npos when it was not.
+     */
+    auto apply(link_state_advert const& advert) noexcept -> std::size_t {
+        auto index = m_origins.find(advert.origin);
+        if (index == npos) {
+            if (advert.version == 0) return npos;
+            index = m_origins.insert(advert.origin);
+            if (index == npos) {
+                ++m_stats.full;
+                return npos;
+            }
+        } else if (!link_state_newer(advert.version, m_entries[index].version)) {
+            ++m_stats.stale;
+            return npos;
+        }
+        m_entries[index] = advert;
+        ++m_stats.applied;
+        return index;
+    }
+
+    // Stored advert of origin, nullptr when unknown.
+    [[nodiscard]] auto find(address_t const& origin) const noexcept -> link_state_advert const* {
+        auto const index = m_origins.find(origin);
+        return index == npos ? nullptr : &m_entries[index];
+    }
+    // 0 when unknown.
+    [[nodiscard]] auto version(address_t const& origin) const noexcept -> std::uint16_t {
+        auto const advert = find(origin);
+        return advert == nullptr ? 0 : advert->version;
+    }
+
+    // Next count origins for a digest, the whole table in turn.
+    auto next_digest(link_state_digest* out, std::size_t count) noexcept -> std::size_t {
+        auto const size = m_origins.size();
+        auto const n = count < size ? count : size;
+        for (std::size_t i = 0; i < n; ++i) {
+            if (m_cursor >= size) m_cursor = 0;
+            auto const& entry = m_entries[m_cursor++];
+            std::memcpy(out[i].origin, entry.origin, address_size);
+            out[i].version = entry.version;
+        }
+        return n;
+    }
+
+    [[nodiscard]] auto operator[](std::size_t index) const noexcept -> link_state_advert const& { return m_entries[index]; }
+    [[nodiscard]] auto size() const noexcept -> std::size_t { return m_origins.size(); }
+    [[nodiscard]] auto capacity() const noexcept -> std::size_t { return CAPACITY; }
+    [[nodiscard]] auto stats() const noexcept -> link_state_stats const& { return m_stats; }
+
+    auto clear() noexcept -> void {
+        m_origins.clear();
+        m_cursor = 0;
+    }
+
+private:
+    address_map<CAPACITY> m_origins{};  // Index of an origin is its entry
+    link_state_advert     m_entries[CAPACITY]{};
+    std::size_t           m_cursor = 0;
+    link_state_stats      m_stats{};
+};
+} // namespace sky
+
+#endif  // !SKY_LINK_STATE_HPP
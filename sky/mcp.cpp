@@ -16,7 +16,7 @@ auto mcp_make_buffer(mcp_buffer_t& dest, mcp const& src) -> void {
     mcp_buffer_t buffer{};
     // Copy to temporay buffer for later computing CRC-8
     std::memcpy(buffer, &src, mcp_buffer_size);
-    buffer[mcp_buffer_size - 1] = crc_8(buffer, mcp_buffer_size - 1);
+    buffer[mcp_buffer_size - 1] = crc_8<mcp_crc_poly>(buffer, mcp_buffer_size - 1);
     // Copy to destination buffer
     std::memcpy(dest, buffer, mcp_buffer_size);
 }
@@ -31,6 +31,7 @@ auto mcp_make_from_buffer(mcp_buffer_t const& src) -> mcp {
     offset += sizeof(address_t);
     std::memcpy(msg.payload,     src + offset, sizeof(payload_t));
     offset += sizeof(payload_t);
+    msg.sequence = src[offset++];
     msg.crc = src[offset];
     return msg;
 }
@@ -50,9 +51,140 @@ auto mcp_u32_to_address(address_t& dest, std::uint32_t const& addr) -> void {
 }
 
 auto mcp_check_crc(mcp_buffer_t const& buffer) -> bool {
-    auto const& packet = mcp_make_from_buffer(buffer);
-    auto const& size = mcp_buffer_size - 1;  // skips the crc end
-    auto const& crc = crc_8(buffer, size);
-    return packet.crc == crc;
+    return mcp_view{buffer}.check_crc();
+}
+
+auto mcp_make_wire(mcp_wire_t& dest, std::uint8_t const* frame) -> void {
+    std::memcpy(dest, frame, mcp_buffer_size);
+    auto const check = crc_16_table<mcp_wire_poly>(frame, mcp_buffer_size);
+    dest[mcp_buffer_size]     = static_cast<std::uint8_t>(check);
+    dest[mcp_buffer_size + 1] = static_cast<std::uint8_t>(check >> 8);
+}
+
+auto mcp_check_wire(std::uint8_t const* wire) -> bool {
+    auto const check = crc_16_table<mcp_wire_poly>(wire, mcp_buffer_size);
+    return wire[mcp_buffer_size] == static_cast<std::uint8_t>(check)
+        && wire[mcp_buffer_size + 1] == static_cast<std::uint8_t>(check >> 8);
+}
+
+auto mcp_view::check_crc() const noexcept -> bool {
+    return crc_8<mcp_crc_poly>(m_data, mcp_crc_offset) == crc();  // skips the crc end
+}
+
+auto mcp_view::to_mcp() const noexcept -> mcp {
+    mcp msg{};
+    std::memcpy(&msg, m_data, mcp_buffer_size);
+    return msg;
+}
+
+namespace {
+/**
+ * @brief CRC-8 over up to mcp_batch_lanes frames at the time. A single frame is a chain of
+ *        dependent table lookups, so interleave a few frames per step and let the lookups
+ *        of independent frames overlap. Running the bitwise CRC on transposed frames with
+ *        SIMD measured slower than this on SSE2, see benchmarks/mcp_benchmarks.hpp.
+ */
+auto crc_8_block(std::uint8_t const* frames, std::size_t count, std::uint8_t (&out)[mcp_batch_lanes]) -> void {
+    constexpr std::size_t interleave = 4;
+    auto const& t = crc_8_lut<mcp_crc_poly>.table;
+    std::size_t i = 0;
+    for (; i + interleave <= count; i += interleave) {
+        std::uint8_t reg[interleave]{};
+        std::uint8_t const* f[interleave]{};
+        for (std::size_t k = 0; k < interleave; ++k) f[k] = frames + (i + k) * mcp_buffer_size;
+        std::size_t j = 0;
+        for (; j + 4 <= mcp_crc_offset; j += 4) {
+            for (std::size_t k = 0; k < interleave; ++k)
+                reg[k] = t[3][reg[k] ^ f[k][j]] ^ t[2][f[k][j + 1]] ^ t[1][f[k][j + 2]] ^ t[0][f[k][j + 3]];
+        }
+        for (; j < mcp_crc_offset; ++j) {
+            for (std::size_t k = 0; k < interleave; ++k)
+                reg[k] = t[0][reg[k] ^ f[k][j]];
+        }
+        for (std::size_t k = 0; k < interleave; ++k) out[i + k] = reg[k];
+    }
+    for (; i < count; ++i)
+        out[i] = crc_8_slice_4<mcp_crc_poly>(frames + i * mcp_buffer_size, mcp_crc_offset);
+}
+
+auto check_crc_block(std::uint8_t const* frames, std::size_t count) -> std::uint32_t {
+    std::uint8_t crc[mcp_batch_lanes]{};
+    crc_8_block(frames, count, crc);
+    std::uint32_t valid = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        auto const ok = crc[i] == frames[i * mcp_buffer_size + mcp_crc_offset];
+        valid |= static_cast<std::uint32_t>(ok) << i;
+    }
+    return valid;
+}
+
+auto popcount(std::uint32_t value) -> std::size_t {
+    std::size_t count = 0;
+    for (; value != 0; value &= value - 1) ++count;
+    return count;
+}
+} // namespace
+
+auto mcp_encode_batch(mcp_buffer_t* dest, mcp const* src, std::size_t count) -> void {
+    static_assert(sizeof(mcp) == mcp_buffer_size, "mcp must have the same layout as the buffer");
+    std::memcpy(dest, src, count * mcp_buffer_size);
+    auto* frames = reinterpret_cast<std::uint8_t*>(dest);
+    for (std::size_t block = 0; block < count; block += mcp_batch_lanes) {
+        auto const n = count - block < mcp_batch_lanes ? count - block : mcp_batch_lanes;
+        std::uint8_t crc[mcp_batch_lanes]{};
+        crc_8_block(frames + block * mcp_buffer_size, n, crc);
+        for (std::size_t i = 0; i < n; ++i)
+            frames[(block + i) * mcp_buffer_size + mcp_crc_offset] = crc[i];
+    }
+}
+
+auto mcp_decode_batch(mcp* dest, mcp_buffer_t const* src, std::size_t count, std::uint32_t* out_valid) -> std::size_t {
+    std::memcpy(dest, src, count * mcp_buffer_size);
+    return mcp_check_crc_batch(src, count, out_valid);
+}
+
+auto mcp_check_crc_batch(mcp_buffer_t const* buffers, std::size_t count, std::uint32_t* out_valid) -> std::size_t {
+    auto const* frames = reinterpret_cast<std::uint8_t const*>(buffers);
+    std::size_t valid = 0;
+    for (std::size_t block = 0; block < count; block += mcp_batch_lanes) {
+        auto const n = count - block < mcp_batch_lanes ? count - block : mcp_batch_lanes;
+        auto const mask = check_crc_block(frames + block * mcp_buffer_size, n);
+        out_valid[block / mcp_batch_lanes] = mask;
+        valid += popcount(mask);
+    }
+    return valid;
+}
+
+auto mcp_crc_update(std::uint8_t& crc, std::size_t offset, std::uint8_t const* old_bytes,
+                    std::uint8_t const* new_bytes, std::size_t size) -> bool {
+    if (offset > mcp_crc_offset || size > mcp_crc_offset - offset) return false;
+    crc = crc_8_update<mcp_crc_poly>(crc, old_bytes, new_bytes, size, mcp_crc_offset - offset - size);
+    return true;
+}
+
+auto mcp_mut_view::set_destination(address_t const& destination) noexcept -> void {
+    // Bytes following the destination up to the crc, fixed for the frame layout
+    constexpr auto trailing = mcp_crc_offset - mcp_destination_offset - sizeof(address_t);
+    auto const& t     = crc_8_lut<mcp_crc_poly>.table[0];
+    auto const& shift = crc_8_shift_lut<mcp_crc_poly, trailing>;
+
+    auto* field = m_data + mcp_destination_offset;
+    std::uint8_t delta = 0x00;
+    for (std::size_t i = 0; i < sizeof(address_t); ++i) {
+        delta = t[delta ^ field[i] ^ destination[i]];
+        field[i] = destination[i];
+    }
+    m_data[mcp_crc_offset] ^= shift[delta];
+}
+
+auto mcp_mut_view::set_payload(std::size_t index, std::uint8_t value) noexcept -> void {
+    if (index >= payload_size) return;
+    auto const offset = mcp_payload_offset + index;
+    if (!mcp_crc_update(m_data[mcp_crc_offset], offset, m_data + offset, &value, 1)) return;
+    m_data[offset] = value;
+}
+
+auto mcp_mut_view::update_crc() noexcept -> void {
+    m_data[mcp_crc_offset] = crc_8<mcp_crc_poly>(m_data, mcp_crc_offset);
 }
 }
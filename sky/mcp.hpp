@@ -15,6 +15,7 @@
 namespace sky {
 constexpr std::size_t address_size = 3;
 constexpr std::size_t payload_size = 15;
+constexpr std::uint8_t mcp_crc_poly = 0x07;  // CRC-8 polynomial used for every frame
 using address_t = uint8_t[address_size];
 using payload_t = uint8_t[payload_size];
 
@@ -24,17 +25,133 @@ struct mcp {
     address_t source;
     address_t destination;
     payload_t payload;
+    uint8_t   sequence;  // Per source counter, copies of the same frame share it
     uint8_t   crc;
 };
 
 constexpr std::size_t mcp_buffer_size = sizeof(mcp);
 using mcp_buffer_t = uint8_t[mcp_buffer_size];
 
+// Byte offset of every field in a serialised frame.
+constexpr std::size_t mcp_type_offset        = offsetof(mcp, type);
+constexpr std::size_t mcp_source_offset      = offsetof(mcp, source);
+constexpr std::size_t mcp_destination_offset = offsetof(mcp, destination);
+constexpr std::size_t mcp_payload_offset     = offsetof(mcp, payload);
+constexpr std::size_t mcp_sequence_offset    = offsetof(mcp, sequence);
+constexpr std::size_t mcp_crc_offset         = offsetof(mcp, crc);
+static_assert(mcp_crc_offset == mcp_buffer_size - 1, "crc must be the last byte in the frame");
+
+// On a byte stream every frame is followed by a CRC-16 of it, little endian. There is no sync
+// byte, a receiver finds frames by their checks and the CRC-8 alone lets about one shifted
+// window in 11000 through, see mcp_deframer.
+constexpr std::uint16_t mcp_wire_poly = 0x1021;
+constexpr std::size_t mcp_wire_size = mcp_buffer_size + 2;
+using mcp_wire_t = uint8_t[mcp_wire_size];
+
+/**
+ * @brief Non-owning read-only view over a serialised frame.
+ *        Fields are read straight from the underlying bytes, nothing is copied.
+ *        The buffer must be at least mcp_buffer_size bytes and outlive the view.
+ */
+class mcp_view {
+public:
+    explicit mcp_view(std::uint8_t const* data) noexcept : m_data(data) {}
+
+    [[nodiscard]] auto type() const noexcept -> std::uint8_t { return m_data[mcp_type_offset]; }
+    [[nodiscard]] auto source() const noexcept -> address_t const& {
+        return *reinterpret_cast<address_t const*>(m_data + mcp_source_offset);
+    }
+    [[nodiscard]] auto destination() const noexcept -> address_t const& {
+        return *reinterpret_cast<address_t const*>(m_data + mcp_destination_offset);
+    }
+    [[nodiscard]] auto payload() const noexcept -> payload_t const& {
+        return *reinterpret_cast<payload_t const*>(m_data + mcp_payload_offset);
+    }
+    [[nodiscard]] auto sequence() const noexcept -> std::uint8_t { return m_data[mcp_sequence_offset]; }
+    [[nodiscard]] auto crc() const noexcept -> std::uint8_t { return m_data[mcp_crc_offset]; }
+
+    [[nodiscard]] auto data() const noexcept -> std::uint8_t const* { return m_data; }
+    [[nodiscard]] auto check_crc() const noexcept -> bool;
+    [[nodiscard]] auto to_mcp() const noexcept -> mcp;
+
+private:
+    std::uint8_t const* m_data;
+};
+
+/**
+ * @brief Non-owning mutable view over a serialised frame.
+ *        The setters patch the bytes in place and keep the CRC valid.
+ */
+class mcp_mut_view {
+public:
+    explicit mcp_mut_view(std::uint8_t* data) noexcept : m_data(data) {}
+
+    operator mcp_view() const noexcept { return mcp_view{m_data}; }
+
+    [[nodiscard]] auto type() const noexcept -> std::uint8_t { return mcp_view{m_data}.type(); }
+    [[nodiscard]] auto source() const noexcept -> address_t const& { return mcp_view{m_data}.source(); }
+    [[nodiscard]] auto destination() const noexcept -> address_t const& { return mcp_view{m_data}.destination(); }
+    [[nodiscard]] auto payload() const noexcept -> payload_t const& { return mcp_view{m_data}.payload(); }
+    [[nodiscard]] auto sequence() const noexcept -> std::uint8_t { return m_data[mcp_sequence_offset]; }
+    [[nodiscard]] auto crc() const noexcept -> std::uint8_t { return m_data[mcp_crc_offset]; }
+    [[nodiscard]] auto data() const noexcept -> std::uint8_t* { return m_data; }
+
+    // Setters update the CRC incrementally from the changed bytes.
+    auto set_destination(address_t const& destination) noexcept -> void;
+    auto set_payload(std::size_t index, std::uint8_t value) noexcept -> void;
+    // Recompute the CRC over the whole frame.
+    auto update_crc() noexcept -> void;
+
+private:
+    std::uint8_t* m_data;
+};
+
 auto mcp_make_buffer(mcp_buffer_t& dest, mcp const& src) -> void;
 auto mcp_make_from_buffer(mcp_buffer_t const& src) -> mcp;
 auto mcp_address_to_u32(address_t const& addr) -> std::uint32_t;
 auto mcp_u32_to_address(address_t& dest, std::uint32_t const& addr) -> void;
 auto mcp_check_crc(mcp_buffer_t const& buffer) -> bool;
+// Frame as it goes on the wire, frame must be mcp_buffer_size bytes with its CRC-8 set.
+auto mcp_make_wire(mcp_wire_t& dest, std::uint8_t const* frame) -> void;
+// Only the CRC-16 trailer, the frame's own CRC is checked on its own.
+auto mcp_check_wire(std::uint8_t const* wire) -> bool;
+
+// Frames handled per block by the batch functions, also the bits per validity mask word.
+constexpr std::size_t mcp_batch_lanes = 32;
+
+// Number of validity mask words needed for count frames.
+constexpr auto mcp_batch_mask_words(std::size_t count) -> std::size_t {
+    return (count + mcp_batch_lanes - 1) / mcp_batch_lanes;
+}
+
+/**
+ * @brief Batch versions of mcp_make_buffer, mcp_make_from_buffer and mcp_check_crc over
+ *        contiguous arrays of frames. The CRC is computed for a block of frames at the time
+ *        with the table lookups of several frames interleaved, the frames are copied in one go.
+ *
+ *        Validity is written as a bitmask, bit i % 32 of out_valid[i / 32] is set when frame i
+ *        has a correct CRC. out_valid must hold mcp_batch_mask_words(count) words.
+ *
+ * @return Number of valid frames for the decode and check functions.
+ */
+auto mcp_encode_batch(mcp_buffer_t* dest, mcp const* src, std::size_t count) -> void;
+auto mcp_decode_batch(mcp* dest, mcp_buffer_t const* src, std::size_t count, std::uint32_t* out_valid) -> std::size_t;
+auto mcp_check_crc_batch(mcp_buffer_t const* buffers, std::size_t count, std::uint32_t* out_valid) -> std::size_t;
+
+/**
+ * @brief Compute the CRC of a frame after a field changed, from the old and new bytes
+ *        of that field only. Gives the same result as recomputing over the whole frame.
+ *
+ * @param crc       CRC stored in the frame before the change, updated in place.
+ * @param offset    Byte offset of the field, e.g. mcp_destination_offset.
+ * @param old_bytes Previous content of the field.
+ * @param new_bytes New content of the field.
+ * @param size      Size of the field in bytes.
+ * @return false when the field is not within the bytes the CRC covers, crc is left as it was
+ *         and no longer matches the frame, so the frame must not be sent.
+ */
+[[nodiscard]] auto mcp_crc_update(std::uint8_t& crc, std::size_t offset, std::uint8_t const* old_bytes,
+                                  std::uint8_t const* new_bytes, std::size_t size) -> bool;
 }
 
 #endif  // !SKY_MCP_HPP
@@ -7,9 +7,18 @@
  */
 #ifndef SKY_QUEUE_HPP
 #define SKY_QUEUE_HPP
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <type_traits>
 #include <utility>
 
 namespace sky {
+/**
+ * @brief Ring buffer of SIZE elements.
+ *        enq and emplace never fail, when the queue is full the oldest element is
+ *        overwritten and counted in overwritten(). try_enq_n only fills free slots.
+ */
 template <typename T, size_t SIZE>
 class queue {
 public:
@@ -19,18 +28,81 @@ public:
     queue(queue&&) = delete;
 
     auto enq(T data) -> void {
-        m_buffer[m_tail] = std::move(data);
-        inc(m_tail, SIZE);
-        if (m_size == SIZE) inc(m_head, SIZE);
-        else ++m_size;
+        slot() = std::move(data);
+    }
+
+    /**
+     * @brief Construct the element in the tail slot, overwrites the oldest when full.
+     *        The slot always holds an element, it is destroyed and built again in place.
+     *        When T{args...} can throw it is built aside and moved in instead, so a throw
+     *        leaves the queue as it was.
+     */
+    template <typename... Args>
+    auto emplace(Args&&... args) -> T& {
+        if constexpr (noexcept(T{std::declval<Args>()...})) {
+            auto& value = slot();
+            value.~T();
+            return *::new (static_cast<void*>(&value)) T{std::forward<Args>(args)...};
+        } else {
+            T value{std::forward<Args>(args)...};
+            return slot() = std::move(value);
+        }
+    }
+
+    /**
+     * @brief Copy up to count elements into the free slots, at most two memcpy calls.
+     * @return Number of elements copied.
+     */
+    auto try_enq_n(T const* data, size_t count) -> size_t {
+        auto const n = count < SIZE - m_size ? count : SIZE - m_size;
+        auto const first = n < SIZE - m_tail ? n : SIZE - m_tail;
+        copy(m_buffer + m_tail, data, first);
+        copy(m_buffer, data + first, n - first);
+        m_tail = (m_tail + n) % SIZE;
+        m_size += n;
+        return n;
     }
 
     [[nodiscard]] auto deq() noexcept -> T {
-        if (m_head == m_tail) return m_buffer[m_head];
-        auto const& value = m_buffer[m_head];
+        if (m_size == 0) return m_buffer[m_head];  // head == tail also when full
+        T value = std::move(m_buffer[m_head]);
+        pop();
+        return value;
+    }
+
+    /**
+     * @brief Copy up to count elements from the front into out, at most two memcpy calls.
+     * @return Number of elements copied.
+     */
+    auto deq_n(T* out, size_t count) -> size_t {
+        auto const n = count < m_size ? count : m_size;
+        auto const first = n < SIZE - m_head ? n : SIZE - m_head;
+        copy(out, m_buffer + m_head, first);
+        copy(out + first, m_buffer, n - first);
+        m_head = (m_head + n) % SIZE;
+        m_size -= n;
+        return n;
+    }
+
+    // Oldest element without copying, only valid when not empty.
+    [[nodiscard]] auto front() noexcept -> T& {
+        return m_buffer[m_head];
+    }
+    [[nodiscard]] auto front() const noexcept -> T const& {
+        return m_buffer[m_head];
+    }
+    // Element i counted from the front, only valid for i < size().
+    [[nodiscard]] auto at(size_t i) noexcept -> T& {
+        return m_buffer[(m_head + i) % SIZE];
+    }
+    [[nodiscard]] auto at(size_t i) const noexcept -> T const& {
+        return m_buffer[(m_head + i) % SIZE];
+    }
+    // Drop the front element, pair with front() for zero-copy consumption.
+    auto pop() noexcept -> void {
+        if (m_size == 0) return;
         inc(m_head, SIZE);
         --m_size;
-        return value;
     }
 
     [[nodiscard]] auto empty() const noexcept -> bool {
@@ -47,6 +119,10 @@ public:
     [[nodiscard]] auto capacity() const noexcept -> size_t {
         return SIZE;
     }
+    // Elements lost to enq or emplace on a full queue since construction.
+    [[nodiscard]] auto overwritten() const noexcept -> size_t {
+        return m_overwritten;
+    }
 
     auto clear() noexcept -> void {
         m_size = 0;
@@ -55,6 +131,27 @@ public:
     }
 
 private:
+    // Claim the tail slot, advancing head past the oldest element when full.
+    auto slot() noexcept -> T& {
+        auto& value = m_buffer[m_tail];
+        inc(m_tail, SIZE);
+        if (m_size == SIZE) {
+            inc(m_head, SIZE);
+            ++m_overwritten;
+        } else {
+            ++m_size;
+        }
+        return value;
+    }
+
+    static auto copy(T* dest, T const* src, size_t count) -> void {
+        if (count == 0) return;
+        if constexpr (std::is_trivially_copyable<T>::value) {
+            std::memcpy(dest, src, count * sizeof(T));
+        } else {
+            for (size_t i = 0; i < count; ++i) dest[i] = src[i];
+        }
+    }
     static auto inc(size_t& value, size_t const& size) noexcept -> void {
         value = (value + 1) % size;
     }
@@ -67,6 +164,7 @@ private:
     size_t m_head = 0;
     size_t m_tail = 0;
     size_t m_size = 0;
+    size_t m_overwritten = 0;
 };
 }
 
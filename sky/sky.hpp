@@ -12,8 +12,16 @@
 #define SKY_SKY_HPP
 
 #include "utility.hpp"
+#include "crc.hpp"
 #include "mcp.hpp"
+#include "deframer.hpp"
+#include "dedup.hpp"
+#include "address_map.hpp"
 #include "topo.hpp"
+#include "sparse_topo.hpp"
+#include "exit_tree.hpp"
+#include "link_state.hpp"
 #include "queue.hpp"
+#include "spsc_queue.hpp"
 
 #endif  // !SKY_SKY_HPP
@@ -0,0 +1,199 @@
+/**
+ * @file   sparse_topo.hpp
+ * @author Pratchaya Khansomboon (me@mononerv.dev)
+ * @brief  Graph topology in compressed sparse rows and Dijkstra shortest path calculation.
+ * @date   2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ */
+#ifndef SKY_SPARSE_TOPO_HPP
+#define SKY_SPARSE_TOPO_HPP
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <functional>
+
+#include "topo.hpp"
+
+namespace sky {
+using topo_index_t = std::uint16_t;
+
+/**
+ * @brief Topology of NODES nodes with room for EDGES directed links, each undirected link
+ *        takes two. The links of node i are column/cost[row[i]] up to row[i + 1], so memory
+ *        grows with the links and not with NODES^2 like sky::topo.
+ *
+ *        Node indices start at 0. Adding a link shifts the links after it, that is fine for
+ *        a topology that is built once and then changes at most a few times.
+ */
+template <std::size_t NODES, std::size_t EDGES>
+struct sparse_topo {
+    static_assert(NODES > 0 && NODES <= 0xFFFF, "node index must fit topo_index_t");
+    static constexpr std::size_t node_capacity = NODES;
+    static constexpr std::size_t edge_capacity = EDGES;
+
+    std::uint32_t row[NODES + 1];
+    topo_index_t  column[EDGES];
+    std::int8_t   cost[EDGES];
+    bool          fire[NODES];
+};
+
+namespace detail {
+template <std::size_t NODES, std::size_t EDGES>
+auto sparse_topo_find(sparse_topo<NODES, EDGES> const& topology, std::size_t from, std::size_t to) -> std::uint32_t {
+    for (auto e = topology.row[from]; e < topology.row[from + 1]; ++e)
+        if (topology.column[e] == to) return e;
+    return topology.row[NODES];
+}
+
+template <std::size_t NODES, std::size_t EDGES>
+auto sparse_topo_insert(sparse_topo<NODES, EDGES>& topology, std::size_t from, std::size_t to, std::int8_t cost) -> bool {
+    auto const e = sparse_topo_find(topology, from, to);
+    if (e != topology.row[NODES]) {
+        topology.cost[e] = cost;
+        return true;
+    }
+    auto const count = topology.row[NODES];
+    if (count == EDGES) return false;
+
+    auto const at = topology.row[from + 1];
+    std::copy_backward(topology.column + at, topology.column + count, topology.column + count + 1);
+    std::copy_backward(topology.cost + at, topology.cost + count, topology.cost + count + 1);
+    topology.column[at] = static_cast<topo_index_t>(to);
+    topology.cost[at]   = cost;
+    for (auto i = from + 1; i < NODES + 1; ++i) ++topology.row[i];
+    return true;
+}
+
+template <std::size_t NODES, std::size_t EDGES>
+auto sparse_topo_erase(sparse_topo<NODES, EDGES>& topology, std::size_t from, std::size_t to) -> void {
+    auto const e = sparse_topo_find(topology, from, to);
+    auto const count = topology.row[NODES];
+    if (e == count) return;
+    std::copy(topology.column + e + 1, topology.column + count, topology.column + e);
+    std::copy(topology.cost + e + 1, topology.cost + count, topology.cost + e);
+    for (auto i = from + 1; i < NODES + 1; ++i) --topology.row[i];
+}
+} // namespace detail
+
+template <std::size_t NODES, std::size_t EDGES>
+auto sparse_topo_clear(sparse_topo<NODES, EDGES>& topology) -> void {
+    std::fill(topology.row, topology.row + NODES + 1, 0u);
+    std::fill(topology.fire, topology.fire + NODES, false);
+}
+
+/**
+ * @brief Set the cost of the link in both directions, a cost <= 0 removes it.
+ * @return false if there is no room left for the link.
+ */
+template <std::size_t NODES, std::size_t EDGES>
+auto sparse_topo_set_node_link_cost(sparse_topo<NODES, EDGES>& topology, std::uint32_t node_id, std::uint32_t end_node_id, std::int8_t cost) -> bool {
+    if (node_id >= NODES || end_node_id >= NODES || node_id == end_node_id) return false;
+    if (cost <= 0) {
+        detail::sparse_topo_erase(topology, node_id, end_node_id);
+        detail::sparse_topo_erase(topology, end_node_id, node_id);
+        return true;
+    }
+    if (!detail::sparse_topo_insert(topology, node_id, end_node_id, cost)) return false;
+    if (detail::sparse_topo_insert(topology, end_node_id, node_id, cost)) return true;
+    detail::sparse_topo_erase(topology, node_id, end_node_id);
+    return false;
+}
+
+// Remove the node and every link to it.
+template <std::size_t NODES, std::size_t EDGES>
+auto sparse_topo_set_node_firemode(sparse_topo<NODES, EDGES>& topology, std::uint32_t node_id) -> void {
+    if (node_id >= NODES) return;
+    while (topology.row[node_id] != topology.row[node_id + 1]) {
+        auto const other = topology.column[topology.row[node_id + 1] - 1];
+        detail::sparse_topo_erase(topology, other, node_id);
+        detail::sparse_topo_erase(topology, node_id, other);
+    }
+    topology.fire[node_id] = true;
+}
+
+// Take the node out of fire mode, its links have to be added again.
+template <std::size_t NODES, std::size_t EDGES>
+auto sparse_topo_clear_node_firemode(sparse_topo<NODES, EDGES>& topology, std::uint32_t node_id) -> void {
+    if (node_id >= NODES) return;
+    topology.fire[node_id] = false;
+}
+
+/**
+ * @brief Build from the dense matrix, matrix[i][j] > 0 is a link from i to j and
+ *        matrix[i][i] == -1 is a node in fire mode.
+ * @return false if the matrix has more links than EDGES.
+ */
+template <std::size_t NODES, typename Index, std::size_t EDGES>
+auto sparse_topo_from_dense(sparse_topo<NODES, EDGES>& out, basic_topo<NODES, Index> const& topology) -> bool {
+    std::uint32_t count = 0;
+    for (std::size_t i = 0; i < NODES; ++i) {
+        out.row[i]  = count;
+        out.fire[i] = topology.matrix[i][i] == -1;
+        for (std::size_t j = 0; j < NODES; ++j) {
+            if (i == j || topology.matrix[i][j] <= 0) continue;
+            if (count == EDGES) return false;
+            out.column[count] = static_cast<topo_index_t>(j);
+            out.cost[count]   = topology.matrix[i][j];
+            ++count;
+        }
+    }
+    out.row[NODES] = count;
+    return true;
+}
+
+/**
+ * @brief Shortest path with a binary heap, O((V + E) log V).
+ *
+ * @param out      Node indices from src to dest.
+ * @param out_size Capacity of out.
+ * @return Number of nodes in the path, 0 if there is no path or it does not fit in out.
+ */
+template <std::size_t NODES, std::size_t EDGES>
+auto sparse_topo_compute_dijkstra(sparse_topo<NODES, EDGES> const& topology, std::uint32_t src, std::uint32_t dest,
+                                  std::uint32_t* out, std::size_t out_size) -> std::size_t {
+    if (src >= NODES || dest >= NODES || topology.fire[src] || topology.fire[dest]) return 0;
+
+    struct item {
+        std::int32_t distance;
+        topo_index_t node;
+        auto operator>(item const& other) const -> bool { return distance > other.distance; }
+    };
+    constexpr std::int32_t unreached = INT32_MAX;
+    std::int32_t distance[NODES];
+    topo_index_t prev[NODES];
+    item heap[EDGES + 1];
+    std::size_t heap_size = 0;
+    std::fill(distance, distance + NODES, unreached);
+
+    distance[src] = 0;
+    prev[src] = static_cast<topo_index_t>(src);
+    heap[heap_size++] = {0, static_cast<topo_index_t>(src)};
+    while (heap_size > 0) {
+        std::pop_heap(heap, heap + heap_size, std::greater<item>{});
+        auto const current = heap[--heap_size];
+        if (current.distance != distance[current.node]) continue;  // Stale entry
+        if (current.node == dest) break;
+
+        for (auto e = topology.row[current.node]; e < topology.row[current.node + 1]; ++e) {
+            auto const next = topology.column[e];
+            auto const new_distance = current.distance + topology.cost[e];
+            if (new_distance >= distance[next]) continue;
+            distance[next] = new_distance;
+            prev[next] = current.node;
+            heap[heap_size++] = {new_distance, next};
+            std::push_heap(heap, heap + heap_size, std::greater<item>{});
+        }
+    }
+    if (distance[dest] == unreached) return 0;
+
+    std::size_t length = 1;
+    for (auto k = dest; k != src; k = prev[k]) ++length;
+    if (length > out_size) return 0;
+    auto k = dest;
+    for (auto i = length; i > 0; --i, k = prev[k]) out[i - 1] = k;
+    return length;
+}
+} // namespace sky
+
+#endif  // !SKY_SPARSE_TOPO_HPP
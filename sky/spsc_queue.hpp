@@ -0,0 +1,85 @@
+/**
+ * @file   spsc_queue.hpp
+ * @author Pratchaya Khansomboon (me@mononerv.dev)
+ * @brief  Lock-free single-producer/single-consumer fixed size queue
+ * @date   2026-10-17
+ * @copyright Copyright (c) 2022
+ */
+#ifndef SKY_SPSC_QUEUE_HPP
+#define SKY_SPSC_QUEUE_HPP
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+namespace sky {
+constexpr std::size_t cache_line_size = 64;
+
+/**
+ * @brief Same fixed capacity, no heap design as sky::queue but safe with exactly one thread
+ *        calling try_enq and one other thread calling try_deq. Unlike sky::queue it never
+ *        overwrites, the producer can not move the consumer index so try_enq fails when full.
+ *
+ *        Indices run freely and are masked on access. Head and tail sit on separate cache
+ *        lines, each side also keeps a cached copy of the other index so it only reads the
+ *        shared one when the queue looks full or empty.
+ */
+template <typename T, std::size_t SIZE>
+class spsc_queue {
+    static_assert(SIZE > 0 && (SIZE & (SIZE - 1)) == 0, "SIZE must be a power of two");
+
+public:
+    spsc_queue() = default;
+    spsc_queue(spsc_queue const&) = delete;
+    spsc_queue& operator=(spsc_queue const&) = delete;
+    spsc_queue(spsc_queue&&) = delete;
+
+    // Producer only.
+    [[nodiscard]] auto try_enq(T data) -> bool {
+        auto const tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_head_cache == SIZE) {
+            m_head_cache = m_head.load(std::memory_order_acquire);
+            if (tail - m_head_cache == SIZE) return false;
+        }
+        m_buffer[tail & mask] = std::move(data);
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only.
+    [[nodiscard]] auto try_deq(T& out) -> bool {
+        auto const head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail_cache) {
+            m_tail_cache = m_tail.load(std::memory_order_acquire);
+            if (head == m_tail_cache) return false;
+        }
+        out = std::move(m_buffer[head & mask]);
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Exact from the consumer or producer side only when the other side is idle.
+    [[nodiscard]] auto empty() const noexcept -> bool {
+        return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire);
+    }
+    [[nodiscard]] auto size() const noexcept -> std::size_t {
+        return m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire);
+    }
+    [[nodiscard]] auto capacity() const noexcept -> std::size_t {
+        return SIZE;
+    }
+
+private:
+    static constexpr std::size_t mask = SIZE - 1;
+
+    // Written by the consumer
+    alignas(cache_line_size) std::atomic<std::size_t> m_head{0};
+    std::size_t m_tail_cache = 0;
+    // Written by the producer
+    alignas(cache_line_size) std::atomic<std::size_t> m_tail{0};
+    std::size_t m_head_cache = 0;
+
+    alignas(cache_line_size) T m_buffer[SIZE]{};
+};
+}
+
+#endif  // !SKY_SPSC_QUEUE_HPP
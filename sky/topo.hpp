@@ -11,22 +11,419 @@
 #ifndef SKY_TOPO_HPP
 #define SKY_TOPO_HPP
 #include <stddef.h>
+#include <string.h>
+#include <limits>
+#include <type_traits>
 
 #include "mcp.hpp"
+#include "utility.hpp"
 
 namespace sky {
 
 constexpr size_t max_path  = 16;
 constexpr size_t node_size = 16;
-using topo_shortest_t = int32_t[max_path];
 
-struct topo {
-    int8_t matrix[node_size][node_size];
+/**
+ * @brief Adjacency matrix of N nodes, matrix[i][j] > 0 is the cost of the link from i to j,
+ *        -1 no link and -1 on the diagonal a node in firemode.
+ *
+ *        Paths and trees store 1-based node ids as Index. A path visits every node at most once
+ *        so it holds N ids. uint8_t is enough up to 255 nodes and makes them 4x smaller than
+ *        the int32_t of the default topo.
+ */
+template <size_t N, typename Index = int32_t>
+struct basic_topo {
+    static_assert(N > 0, "topology needs at least one node");
+    static_assert(std::is_integral<Index>::value, "Index must be an integer");
+    static_assert(static_cast<uint64_t>(std::numeric_limits<Index>::max()) >= N, "1-based node ids must fit Index");
+
+    static constexpr size_t node_count = N;
+    using index_type = Index;
+    using path_t     = Index[N];    // 1-based nodes from src to dest, zero filled
+    using tree_t     = Index[N];    // 1-based next hop of every node, 0 for none
+    using cost_t     = int32_t[N];  // Distance or load of every node, -1 for none
+    using capacity_t = int8_t[N][N];  // Per link like matrix, how many nodes the link carries
+
+    int8_t matrix[N][N];
 };
 
-auto topo_set_node_link_cost(topo& topology, uint32_t node_id, uint32_t endNode_id, int8_t cost) -> topo;
-auto topo_set_node_firemode(topo& topology, uint32_t node_id) -> void;
-auto topo_compute_dijkstra(topo const& topology, int32_t src, int32_t dest, topo_shortest_t& out_shortest) -> void;
+using topo            = basic_topo<node_size>;
+using topo_shortest_t = topo::path_t;
+using topo_tree_t     = topo::tree_t;
+
+static_assert(sizeof(topo) == node_size * node_size, "one byte per link");
+static_assert(sizeof(topo_shortest_t) == max_path * sizeof(int32_t), "default paths keep int32_t ids");
+static_assert(sizeof(basic_topo<node_size, uint8_t>::path_t) == max_path, "8-bit ids make a path 16 bytes");
+
+namespace detail {
+// Node bitmask for the bitmask searches, topologies beyond 64 nodes scan arrays instead.
+template <size_t N>
+using topo_mask_t = typename std::conditional<N <= 32, uint32_t, uint64_t>::type;
+
+/**
+ * @brief Links of every node as a bitmask, nodes in firemode have none.
+ * @return true if every link costs 1.
+ */
+template <size_t N, typename I>
+auto topo_make_adjacency(basic_topo<N, I> const& topology, topo_mask_t<N> (&adjacency)[N]) -> bool {
+    using mask_t = topo_mask_t<N>;
+    bool unit = true;
+    for (size_t i = 0; i < N; i++) {
+        adjacency[i] = 0;
+        if (topology.matrix[i][i] == -1) continue;
+        for (size_t j = 0; j < N; j++) {
+            if (i == j || topology.matrix[i][j] <= 0 || topology.matrix[j][j] == -1) continue;
+            adjacency[i] |= mask_t{1} << j;
+            unit = unit && topology.matrix[i][j] == 1;
+        }
+    }
+    return unit;
+}
+
+//Breadth first, a whole frontier is expanded at the time
+template <size_t N>
+auto topo_search_bfs(topo_mask_t<N> const (&adjacency)[N], size_t start, size_t end, int32_t (&prev_node)[N]) -> bool {
+    using mask_t = topo_mask_t<N>;
+    mask_t visited  = mask_t{1} << start;
+    mask_t frontier = visited;
+    while (frontier != 0 && (visited & mask_t{1} << end) == 0) {
+        mask_t next = 0;
+        for (auto bits = frontier; bits != 0; bits &= bits - 1) {
+            auto const node = count_trailing_zeros(bits);
+            auto const found = adjacency[node] & ~visited & ~next;
+            for (auto f = found; f != 0; f &= f - 1) prev_node[count_trailing_zeros(f)] = static_cast<int32_t>(node);
+            next |= found;
+        }
+        visited |= next;
+        frontier = next;
+    }
+    return (visited & mask_t{1} << end) != 0;
+}
+
+//Dijkstra, the next node is picked from the reached but unvisited bits
+template <size_t N, typename I>
+auto topo_search_dijkstra(basic_topo<N, I> const& topology, topo_mask_t<N> const (&adjacency)[N], size_t start, size_t end, int32_t (&prev_node)[N]) -> bool {
+    using mask_t = topo_mask_t<N>;
+    int32_t min_distance[N]{};
+    mask_t visited = 0;
+    mask_t reached = mask_t{1} << start;
+    while (true) {
+        auto const open = reached & ~visited;
+        if (open == 0) return false;
+        auto current = count_trailing_zeros(open);
+        for (auto bits = open & (open - 1); bits != 0; bits &= bits - 1) {
+            auto const node = count_trailing_zeros(bits);
+            if (min_distance[node] < min_distance[current]) current = node;
+        }
+        if (current == end) return true;
+        visited |= mask_t{1} << current;
+
+        for (auto bits = adjacency[current] & ~visited; bits != 0; bits &= bits - 1) {
+            auto const node = count_trailing_zeros(bits);
+            auto const new_distance = min_distance[current] + topology.matrix[current][node];
+            if ((reached & mask_t{1} << node) == 0 || new_distance < min_distance[node]) {
+                min_distance[node] = new_distance;
+                prev_node[node] = static_cast<int32_t>(current);
+                reached |= mask_t{1} << node;
+            }
+        }
+    }
+}
+
+//Dijkstra over arrays for topologies too large for a bitmask
+template <size_t N, typename I>
+auto topo_search_dense(basic_topo<N, I> const& topology, size_t start, size_t end, int32_t (&prev_node)[N]) -> bool {
+    int32_t min_distance[N];
+    bool visited[N]{};
+    for (size_t i = 0; i < N; i++) min_distance[i] = -1;
+    min_distance[start] = 0;
+    while (true) {
+        size_t current = N;
+        for (size_t i = 0; i < N; i++) {
+            if (visited[i] || min_distance[i] < 0) continue;
+            if (current == N || min_distance[i] < min_distance[current]) current = i;
+        }
+        if (current == N) return false;
+        if (current == end) return true;
+        visited[current] = true;
+
+        for (size_t i = 0; i < N; i++) {
+            if (visited[i] || i == current || topology.matrix[current][i] <= 0 || topology.matrix[i][i] == -1) continue;
+            auto const new_distance = min_distance[current] + topology.matrix[current][i];
+            if (min_distance[i] < 0 || new_distance < min_distance[i]) {
+                min_distance[i] = new_distance;
+                prev_node[i] = static_cast<int32_t>(current);
+            }
+        }
+    }
+}
+
+/**
+ * Reverse Dijkstra from every exit at once over weight(i, j), the cost of going from i to j
+ * and <= 0 when there is no link. Same outputs as topo_compute_nearest_exit.
+ */
+template <size_t N, typename I, typename Weight>
+auto topo_search_exits(basic_topo<N, I> const& topology, Weight const& weight, int32_t const* exits, size_t exit_count,
+                       I (&out_next)[N], int32_t (&out_distance)[N], I (&out_exit)[N]) -> void {
+    for (size_t i = 0; i < N; i++) {
+        out_next[i] = 0;
+        out_distance[i] = -1;
+        out_exit[i] = 0;
+    }
+    for (size_t i = 0; i < exit_count; i++) {
+        auto const exit = exits[i];
+        if (exit < 1 || static_cast<size_t>(exit) > N) continue;
+        auto const end = static_cast<size_t>(exit - 1);
+        //Exit in firemode, nobody gets out that way
+        if (topology.matrix[end][end] == -1) continue;
+        out_next[end] = static_cast<I>(exit);
+        out_distance[end] = 0;
+        out_exit[end] = static_cast<I>(exit);
+    }
+
+    bool visited[N]{};
+
+    while (true) {
+        //Closest reached node not visited yet
+        size_t current = N;
+        for (size_t i = 0; i < N; i++) {
+            if (visited[i] || out_distance[i] < 0) continue;
+            if (current == N || out_distance[i] < out_distance[current]) current = i;
+        }
+        if (current == N) break;
+        visited[current] = true;
+
+        //Relax the links into current, i -> current
+        for (size_t i = 0; i < N; i++) {
+            if (visited[i] || topology.matrix[i][i] == -1) continue;
+            auto const cost = weight(i, current);
+            if (cost <= 0) continue;
+            auto const new_distance = out_distance[current] + cost;
+            if (out_distance[i] < 0 || new_distance < out_distance[i]) {
+                out_distance[i] = new_distance;
+                out_next[i] = static_cast<I>(current + 1);
+                out_exit[i] = out_exit[current];
+            }
+        }
+    }
+}
+
+// Whether the way out from src goes through node, both 1-based.
+template <size_t N, typename I>
+auto topo_exit_passes(I const (&next)[N], size_t src, size_t node) -> bool {
+    for (size_t hop = 0; hop < N && next[src - 1] != 0; hop++) {
+        if (src == node) return true;
+        if (static_cast<size_t>(next[src - 1]) == src) return false;
+        src = static_cast<size_t>(next[src - 1]);
+    }
+    return false;
+}
+
+// Every link costs cost * load * (1 + load / capacity), the plain path cost of everyone crossing it
+// plus a penalty that grows with the load over that link's capacity. In fixed point so links of
+// different capacity compare, 64 bits since the load of a big topology squares past 32.
+constexpr int64_t topo_congestion_scale = 256;
+
+template <size_t N, typename I>
+auto topo_exit_congestion(basic_topo<N, I> const& topology, I const (&next)[N], int32_t const (&load)[N],
+                          int8_t const (&capacity)[N][N]) -> int64_t {
+    int64_t total = 0;
+    for (size_t i = 0; i < N; i++) {
+        if (next[i] == 0 || static_cast<size_t>(next[i]) == i + 1) continue;
+        auto const j = static_cast<size_t>(next[i] - 1);
+        //A link without a capacity still carries one node
+        int64_t const link_capacity = capacity[i][j] < 1 ? 1 : capacity[i][j];
+        int64_t const link_load = load[i];
+        total += topology.matrix[i][j] * link_load * (link_capacity + link_load) * topo_congestion_scale / link_capacity;
+    }
+    return total;
+}
+} // namespace detail
+
+template <size_t N, typename I>
+auto topo_set_node_link_cost(basic_topo<N, I>& topology, uint32_t node_id, uint32_t endNode_id, int8_t cost) -> basic_topo<N, I>& {
+    topology.matrix[node_id][endNode_id] = cost;
+    topology.matrix[endNode_id][node_id] = cost;
+
+    return topology;
+}
+
+template <size_t N, typename I>
+auto topo_set_node_firemode(basic_topo<N, I>& topology, uint32_t node_id) -> void {
+    //Remove node from topo
+    for (size_t i = 0; i < N; i++)
+    {
+        topology.matrix[node_id][i] = -1;
+        topology.matrix[i][node_id] = -1;
+    }
+}
+
+/**
+ * @brief Shortest path from src to dest, both 1-based. Nodes are kept in bitmasks, when every
+ *        link costs 1 it runs a breadth first search instead of Dijkstra. Beyond 64 nodes it
+ *        falls back to Dijkstra over arrays.
+ *
+ * @param out_shortest 1-based nodes from src to dest, zero filled, all zero when there is no path.
+ */
+template <size_t N, typename I>
+auto topo_compute_dijkstra(basic_topo<N, I> const& topology, int32_t src, int32_t dest, I (&out_shortest)[N]) -> void {
+    memset(out_shortest, 0, sizeof(out_shortest));
+    if (src < 1 || dest < 1 || static_cast<size_t>(src) > N || static_cast<size_t>(dest) > N) return;
+    auto const start = static_cast<size_t>(src - 1);
+    auto const end   = static_cast<size_t>(dest - 1);
+    //If node is in firemode
+    if (topology.matrix[start][start] == -1 || topology.matrix[end][end] == -1) return;
+
+    int32_t prev_node[N]{};
+    bool found = false;
+    if constexpr (N <= 64) {
+        detail::topo_mask_t<N> adjacency[N]{};
+        auto const unit = detail::topo_make_adjacency(topology, adjacency);
+        found = unit ? detail::topo_search_bfs<N>(adjacency, start, end, prev_node)
+                     : detail::topo_search_dijkstra(topology, adjacency, start, end, prev_node);
+    } else {
+        found = detail::topo_search_dense(topology, start, end, prev_node);
+    }
+    if (!found) return;
+
+    //Walk back from dest, then write src first
+    size_t length = 1;
+    for (auto k = end; k != start; k = static_cast<size_t>(prev_node[k])) length++;
+    auto k = end;
+    for (auto i = length; i > 0; i--, k = static_cast<size_t>(prev_node[k])) out_shortest[i - 1] = static_cast<I>(k + 1);
+}
+
+/**
+ * @brief Like topo_compute_exit_tree with every exit seeded at distance 0, so each node is
+ *        routed to its nearest exit in the same single run.
+ *
+ * @param exits    1-based exit nodes, exits out of range or in firemode are skipped.
+ * @param out_exit 1-based nearest exit, 0 when there is no way out.
+ */
+template <size_t N, typename I>
+auto topo_compute_nearest_exit(basic_topo<N, I> const& topology, int32_t const* exits, size_t exit_count,
+                               I (&out_next)[N], int32_t (&out_distance)[N], I (&out_exit)[N]) -> void {
+    auto const weight = [&topology](size_t from, size_t to) -> int32_t { return topology.matrix[from][to]; };
+    detail::topo_search_exits(topology, weight, exits, exit_count, out_next, out_distance, out_exit);
+}
+
+/**
+ * @brief Shortest path tree towards the exit, one Dijkstra run instead of one per node.
+ *        Runs from the exit over the links in reverse, so out_next[i] is the node to go
+ *        to from node i + 1 and out_distance[i] the cost from there to the exit.
+ *
+ * @param exit         Exit node, 1-based like topo_compute_dijkstra.
+ * @param out_next     1-based next hop, the exit points to itself, 0 when there is no way out.
+ * @param out_distance Cost to the exit, -1 when there is no way out.
+ */
+template <size_t N, typename I>
+auto topo_compute_exit_tree(basic_topo<N, I> const& topology, int32_t exit, I (&out_next)[N], int32_t (&out_distance)[N]) -> void {
+    I nearest[N]{};
+    topo_compute_nearest_exit(topology, &exit, 1, out_next, out_distance, nearest);
+}
+
+/**
+ * @brief Everyone at a node walks its way out in the tree, count how many cross each link.
+ *
+ * @param out_load Number of nodes whose way out uses the link from node i + 1 to next[i].
+ * @return The largest load on one link.
+ */
+template <size_t N, typename I>
+auto topo_compute_exit_load(I const (&next)[N], int32_t (&out_load)[N]) -> int32_t {
+    int32_t max_load = 0;
+    for (size_t i = 0; i < N; i++) out_load[i] = 0;
+    for (size_t i = 0; i < N; i++) {
+        if (next[i] == 0) continue;
+        //Walk the way out and count this node on every link of it
+        auto node = i + 1;
+        for (size_t hop = 0; hop < N && static_cast<size_t>(next[node - 1]) != node; hop++) {
+            auto& load = out_load[node - 1];
+            if (++load > max_load) max_load = load;
+            node = static_cast<size_t>(next[node - 1]);
+        }
+    }
+    return max_load;
+}
+
+/**
+ * @brief Next hops that spread the evacuation over alternative routes instead of sending
+ *        everyone down the same corridor. Starts from the nearest exit tree, then every round
+ *        tries to move each node's next hop to another neighbour and keeps the move when it
+ *        lowers the congestion weighted cost, the sum over the links of
+ *        cost * load * (1 + load / capacity). Every tried move recounts the loads, so a round is
+ *        up to N^3 steps, see bm_topo_balanced_exits for timings.
+ *
+ * @param exits    1-based exit nodes like topo_compute_nearest_exit.
+ * @param capacity Per link like matrix, capacity[i][j] is how many nodes the link from i + 1 to
+ *                 j + 1 carries before the congestion outweighs its cost. Below 1 counts as 1.
+ * @param rounds   Improvement rounds, stops early when a round moves nothing. 0 gives the
+ *                 nearest exit tree.
+ * @param out_next 1-based next hop, use with topo_exit_path.
+ * @return The largest link load of out_next, see topo_compute_exit_load.
+ */
+template <size_t N, typename I>
+auto topo_compute_balanced_exits(basic_topo<N, I> const& topology, int32_t const* exits, size_t exit_count,
+                                 int8_t const (&capacity)[N][N], size_t rounds, I (&out_next)[N]) -> int32_t {
+    int32_t distance[N]{};
+    I nearest[N]{};
+    int32_t load[N]{};
+    topo_compute_nearest_exit(topology, exits, exit_count, out_next, distance, nearest);
+    auto max_load = topo_compute_exit_load(out_next, load);
+    auto cost = detail::topo_exit_congestion(topology, out_next, load, capacity);
+
+    I next[N]{};
+    for (size_t round = 0; round < rounds; round++) {
+        bool improved = false;
+        for (size_t i = 0; i < N; i++) {
+            auto const node = i + 1;
+            if (out_next[i] == 0 || static_cast<size_t>(out_next[i]) == node) continue;
+            //Try every other neighbour with a way out that does not come back through i
+            for (size_t j = 0; j < N; j++) {
+                auto const other = j + 1;
+                if (topology.matrix[i][j] <= 0 || out_next[j] == 0 || static_cast<size_t>(out_next[i]) == other) continue;
+                if (detail::topo_exit_passes(out_next, other, node)) continue;
+
+                memcpy(next, out_next, sizeof(next));
+                next[i] = static_cast<I>(other);
+                auto const next_max_load = topo_compute_exit_load(next, load);
+                auto const next_cost = detail::topo_exit_congestion(topology, next, load, capacity);
+                if (next_cost >= cost) continue;
+                memcpy(out_next, next, sizeof(next));
+                max_load = next_max_load;
+                cost = next_cost;
+                improved = true;
+            }
+        }
+        if (!improved) break;
+    }
+    return max_load;
+}
+
+/**
+ * @brief Follow the tree from src to its exit, same output as topo_compute_dijkstra.
+ */
+template <size_t N, typename I>
+auto topo_exit_path(I const (&next)[N], int32_t src, I (&out_shortest)[N]) -> void {
+    memset(out_shortest, 0, sizeof(out_shortest));
+    if (src < 1 || static_cast<size_t>(src) > N || next[src - 1] == 0) return;
+
+    auto node = static_cast<size_t>(src);
+    for (size_t i = 0; i < N; i++) {
+        out_shortest[i] = static_cast<I>(node);
+        if (static_cast<size_t>(next[node - 1]) == node) return;
+        node = static_cast<size_t>(next[node - 1]);
+    }
+}
+
+// The default topology is compiled once in topo.cpp
+extern template auto topo_set_node_link_cost(topo&, uint32_t, uint32_t, int8_t) -> topo&;
+extern template auto topo_set_node_firemode(topo&, uint32_t) -> void;
+extern template auto topo_compute_dijkstra(topo const&, int32_t, int32_t, topo_shortest_t&) -> void;
+extern template auto topo_compute_nearest_exit(topo const&, int32_t const*, size_t, topo_tree_t&, topo::cost_t&, topo_tree_t&) -> void;
+extern template auto topo_compute_exit_tree(topo const&, int32_t, topo_tree_t&, topo::cost_t&) -> void;
+extern template auto topo_compute_exit_load(topo_tree_t const&, topo::cost_t&) -> int32_t;
+extern template auto topo_compute_balanced_exits(topo const&, int32_t const*, size_t, topo::capacity_t const&, size_t, topo_tree_t&) -> int32_t;
+extern template auto topo_exit_path(topo_tree_t const&, int32_t, topo_shortest_t&) -> void;
 } // namespace sky
 
 #endif  // !SKY_TOPO_HPP
@@ -14,12 +14,34 @@
 #include <cstddef>
 #include <type_traits>
 
+#include "crc.hpp"
+
 namespace sky {
 template <typename T, std::size_t N>
 inline constexpr auto length_of(T (&)[N]) -> std::size_t {
     return N;
 }
 
+// Index of the lowest set bit, value must not be 0.
+inline auto count_trailing_zeros(std::uint32_t value) noexcept -> std::size_t {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<std::size_t>(__builtin_ctz(value));
+#else
+    std::size_t count = 0;
+    for (; (value & 1) == 0; value >>= 1) ++count;
+    return count;
+#endif
+}
+inline auto count_trailing_zeros(std::uint64_t value) noexcept -> std::size_t {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<std::size_t>(__builtin_ctzll(value));
+#else
+    std::size_t count = 0;
+    for (; (value & 1) == 0; value >>= 1) ++count;
+    return count;
+#endif
+}
+
 template <typename T, typename = typename std::enable_if<std::is_arithmetic<T>::value, T>::type>
 inline constexpr auto set_bit(T& reg, std::size_t const& position) noexcept -> void {
     reg |= 1 << position;
@@ -34,22 +56,6 @@ template <typename T, typename = typename std::enable_if<std::is_arithmetic<T>::
 inline constexpr auto set_bit_level(T& reg, T const& mask, T const& data) noexcept -> void {
     reg = (reg & ~mask) | (data & mask);
 }
-
-template <std::uint8_t POLY = 0x07>
-inline constexpr auto crc_8(std::uint8_t const* buffer, std::size_t size) -> std::uint8_t {
-    constexpr std::uint8_t poly = POLY;
-    std::uint8_t reg = 0x00;
-    for (std::size_t i = 0; i < size; ++i) {
-        reg = reg ^ buffer[i];
-        for (std::uint8_t j = 0; j < 8; ++j) {
-            if (reg & 0x80)
-                reg = std::uint8_t(reg << 1) ^ poly;
-            else
-                reg = std::uint8_t(reg << 1);
-        }
-    }
-    return reg;
-}
 } // namespace sky
 
 #endif  // !SKY_UTILITY_HPP
@@ -0,0 +1,496 @@
+/**
+ * @file   mesh.cpp
+ * @author Pratchaya Khansomboon (me@mononerv.dev)
+ * @brief  Discrete-event simulation of a mesh of sunlight nodes.
+ * @date   2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ */
+#include "mesh.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace ray {
+namespace {
+// splitmix64, spreads the mesh seed over the nodes
+auto mix(uint64_t value) -> uint64_t {
+    value += 0x9E3779B97F4A7C15ull;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+    return value ^ (value >> 31);
+}
+
+auto make_scheduler(mesh_config const& config) -> std::unique_ptr<channel_scheduler> {
+    if (config.schedule == mesh_schedule::adaptive) {
+        return std::make_unique<adaptive_scheduler>(config.slot_min_us, config.slot_max_us);
+    }
+    return std::make_unique<round_robin_scheduler>(config.slot_min_us, config.slot_max_us);
+}
+
+auto to_signed(uint64_t value) -> int64_t { return static_cast<int64_t>(value); }
+} // namespace
+
+auto mesh::sim_clock::millis() const -> uint32_t {
+    return now < boot ? 0 : static_cast<uint32_t>((now - boot) / 1000);
+}
+
+auto mesh::sim_channels::write(packet const& pkt) noexcept -> void {
+    if (pkt.channel >= MAX_CHANNEL) return;
+    if (trace != nullptr) trace->record({clock.millis(), true, pkt});
+    // The node writes whole frames, type 1 is the flooded topology and 6 and 7 the link-state gossip
+    if (pkt.size == sky::mcp_wire_size) {
+        auto const type = sky::mcp_view{pkt.data}.type();
+        if (type == 1 || type == 6 || type == 7) ++topology_writes;
+    }
+    out[pkt.channel].push(pkt);
+}
+auto mesh::sim_channels::read(uint8_t channel) noexcept -> packet {
+    if (channel >= MAX_CHANNEL) return {};
+    if (in[channel].empty()) return {};
+    auto pkt = in[channel].deq();
+    if (trace != nullptr) trace->record({clock.millis(), false, pkt});
+    return pkt;
+}
+auto mesh::sim_channels::clear_buffer(uint8_t channel) noexcept -> void {
+    if (channel >= MAX_CHANNEL) return;
+    out[channel].clear();
+    in[channel].clear();
+}
+auto mesh::sim_channels::overwritten(uint8_t channel) const noexcept -> std::size_t {
+    if (channel >= MAX_CHANNEL) return 0;
+    return in[channel].overwritten() + out[channel].evicted();
+}
+
+auto mesh::barrier::arrive_and_wait() -> void {
+    auto const generation = m_generation.load(std::memory_order_acquire);
+    if (m_waiting.fetch_add(1, std::memory_order_acq_rel) + 1 == m_count) {
+        m_waiting.store(0, std::memory_order_relaxed);
+        m_generation.fetch_add(1, std::memory_order_acq_rel);
+        return;
+    }
+    for (std::size_t spin = 0; m_generation.load(std::memory_order_acquire) == generation; ++spin) {
+        if (spin >= 64) std::this_thread::yield();
+    }
+}
+
+mesh::sim_node::sim_node(uint32_t address, uint64_t boot, std::unique_ptr<channel_scheduler> slots)
+    : clock(now, boot), chip(address), com(clock), leds(), pins(), light({clock, chip, com, leds, pins, nullptr}),
+      scheduler(std::move(slots)) {}
+
+mesh::mesh(std::size_t node_count, mesh_config const& config) : m_config(config) {
+    for (std::size_t i = 0; i < node_count; ++i) {
+        auto const random = mix(m_config.seed ^ mix(i));
+        auto const boot = m_config.boot_max_us == 0 ? 0 : random % m_config.boot_max_us;
+        auto& n = m_nodes.emplace_back(static_cast<uint32_t>(i + 1), boot, make_scheduler(m_config));
+        n.scheduler->seed(static_cast<uint32_t>(random >> 32));
+        for (auto& out : n.com.out) {
+            out.set_coalesce(m_config.coalesce);
+            out.set_priority(m_config.priority);
+        }
+        for (auto& peer : n.peer) peer = node_count;
+        n.light.set_link_state(m_config.link_state);
+        n.light.setup();
+        next_slot(n, boot, n.scheduler->first());
+    }
+}
+
+mesh::~mesh() {
+    if (m_workers.empty()) return;
+    m_stop.store(true);
+    m_barrier->arrive_and_wait();
+    for (auto& worker : m_workers) worker.join();
+}
+
+auto mesh::connect(std::size_t a, uint8_t a_channel, std::size_t b, uint8_t b_channel) -> bool {
+    if (a >= size() || b >= size() || a == b || a_channel >= MAX_CHANNEL || b_channel >= MAX_CHANNEL) return false;
+    auto& x = m_nodes[a];
+    auto& y = m_nodes[b];
+    if (x.peer[a_channel] != size() || y.peer[b_channel] != size()) return false;
+    x.peer[a_channel] = b;
+    x.peer_channel[a_channel] = b_channel;
+    y.peer[b_channel] = a;
+    y.peer_channel[b_channel] = a_channel;
+    m_partitioned = false;
+    return true;
+}
+
+auto mesh::set_exit(std::size_t index) -> void {
+    if (index < size()) m_nodes[index].pins.exit = true;
+}
+
+auto mesh::set_fire(std::size_t index, uint64_t at_us) -> void {
+    if (index < size()) m_nodes[index].fire_at = std::min(m_nodes[index].fire_at, at_us);
+}
+
+auto mesh::set_recorder(std::size_t index, recorder* rec) -> void {
+    if (index < size()) m_nodes[index].com.trace = rec;
+}
+
+auto mesh::counters(std::size_t index, uint8_t channel) const -> channel_counters {
+    if (index >= size() || channel >= MAX_CHANNEL) return {};
+    auto const& com = m_nodes[index].com;
+    auto result = com.counters[channel];
+    result.suppressed = com.out[channel].suppressed();
+    result.evicted    = com.out[channel].evicted();
+    result.in_depth  = com.in[channel].size();
+    result.out_depth = com.out[channel].size();
+    return result;
+}
+
+auto mesh::byte_time(std::size_t bytes) const -> uint64_t {
+    return bytes * 10u * 1'000'000u / m_config.baud;
+}
+
+auto mesh::next_slot(sim_node& n, uint64_t start, slot next) -> void {
+    n.channel = next.channel;
+    n.lingered = false;
+    n.slot_start = start;
+    n.wake = start + next.interval_us;
+}
+
+// Contiguous index ranges, rows of a grid stay together and only the rows at a cut are boundary.
+auto mesh::partition_nodes() -> void {
+    auto const count = std::max<std::size_t>(1, std::min(m_config.threads, size()));
+    if (m_partitions.size() != count) m_partitions = std::vector<partition>(count);
+    m_partition_of.assign(size(), 0);
+    for (std::size_t p = 0; p < count; ++p) {
+        auto& part = m_partitions[p];
+        part.begin = size() * p / count;
+        part.end   = size() * (p + 1) / count;
+        for (auto i = part.begin; i < part.end; ++i) m_partition_of[i] = p;
+        part.outbox.resize(count);
+    }
+    for (auto& part : m_partitions) {
+        part.events = {};
+        part.boundary.clear();
+        for (auto i = part.begin; i < part.end; ++i) {
+            auto const& n = m_nodes[i];
+            part.events.push({n.wake, i});
+            auto const wired_out = std::any_of(std::begin(n.peer), std::end(n.peer), [&](std::size_t peer) {
+                return peer < size() && m_partition_of[peer] != m_partition_of[i];
+            });
+            if (wired_out) part.boundary.push_back(i);
+        }
+    }
+    m_partitioned = true;
+}
+
+auto mesh::start_workers() -> void {
+    m_barrier = std::make_unique<barrier>(m_partitions.size());
+    for (std::size_t p = 1; p < m_partitions.size(); ++p) {
+        m_workers.emplace_back([this, p] {
+            while (true) {
+                m_barrier->arrive_and_wait();
+                if (m_stop.load()) return;
+                run_partition(p, m_end);
+            }
+        });
+    }
+}
+
+auto mesh::run_until(uint64_t end_us) -> void {
+    auto const wall_start = std::chrono::steady_clock::now();
+    if (!m_partitioned) partition_nodes();
+    if (m_partitions.size() > 1) {
+        // The partition count only depends on the node count and the config, neither changes
+        if (m_workers.empty()) start_workers();
+        m_end = end_us;
+        m_barrier->arrive_and_wait();
+    }
+    run_partition(0, end_us);
+    m_now = std::max(m_now, end_us);
+    m_wall_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+}
+
+// Earliest a boundary node can put a byte on a wire to another partition. It sends on its
+// current channel at wake at the soonest, any other channel is whole slots after that.
+auto mesh::horizon(partition const& part) const -> uint64_t {
+    auto result = never;
+    for (auto const i : part.boundary) {
+        auto const& n = m_nodes[i];
+        for (std::size_t ch = 0; ch < MAX_CHANNEL; ++ch) {
+            auto const peer = n.peer[ch];
+            if (peer >= size() || m_partition_of[peer] == m_partition_of[i]) continue;
+            auto const slots = n.scheduler->min_slots(n.channel, static_cast<uint8_t>(ch));
+            result = std::min(result, n.wake + slots * m_config.slot_min_us + byte_time(1));
+        }
+    }
+    return result;
+}
+
+auto mesh::deliver(std::size_t index) -> void {
+    for (auto& from : m_partitions) {
+        auto& mailbox = from.outbox[index];
+        for (auto const& d : mailbox) m_nodes[d.node].incoming[d.channel].push_back(d.tx);
+        mailbox.clear();
+    }
+}
+
+auto mesh::run_partition(std::size_t index, uint64_t end_us) -> void {
+    auto& part = m_partitions[index];
+    auto const single = m_partitions.size() == 1;
+    while (true) {
+        deliver(index);
+        part.horizon = horizon(part);
+        part.next = part.events.empty() ? never : part.events.top().time;
+        if (!single) m_barrier->arrive_and_wait();
+
+        // Every partition reads the same values here and agrees on the window
+        auto window_end = end_us == never ? never : end_us + 1;
+        auto first = never;
+        for (auto const& other : m_partitions) {
+            window_end = std::min(window_end, other.horizon);
+            first = std::min(first, other.next);
+        }
+        if (first > end_us) break;
+        if (index == 0) ++m_windows;
+
+        while (!part.events.empty() && part.events.top().time < window_end) {
+            auto const current = part.events.top();
+            part.events.pop();
+            slot_end(part, current.node);
+        }
+        if (!single) m_barrier->arrive_and_wait();
+    }
+}
+
+// multicom done state: read what arrived on the channel, else send one packet, then move on.
+auto mesh::slot_end(partition& part, std::size_t index) -> void {
+    auto& n = m_nodes[index];
+    n.now = n.wake;
+    ++part.events_run;
+    if (!n.lingered) {
+        // multicom keeps listening while a packet it caught the start of is still coming in
+        if (auto const until = linger(n); until > n.now) {
+            n.lingered = true;
+            n.wake = until;
+            part.events.push({n.wake, index});
+            return;
+        }
+    }
+    // Switches flip between slots, they are read on the node's next loop
+    if (n.fire_at <= n.now) n.pins.fire = true;
+    run_node(part, n);
+
+    uint64_t busy = 0;
+    slot_outcome outcome{};
+    ++n.com.counters[n.channel].slots;
+    if (receive(part, n)) {
+        outcome.received = true;
+        run_node(part, n);
+    } else if (!n.com.out[n.channel].empty()) {
+        outcome.sent = true;
+        busy = transmit(part, n);
+    }
+    std::size_t pending[MAX_CHANNEL];
+    for (std::size_t i = 0; i < MAX_CHANNEL; ++i) {
+        pending[i] = n.com.out[i].size();
+        auto& since = n.queued_since[i];
+        if (pending[i] > 0 && since == never) {
+            since = n.now;
+        } else if (pending[i] == 0 && since != never) {
+            part.drain_total += n.now - since;
+            ++part.drains;
+            since = never;
+        }
+    }
+    next_slot(n, n.now + busy, n.scheduler->next(n.channel, outcome, pending));
+    part.events.push({n.wake, index});
+}
+
+auto mesh::receive(partition& part, sim_node& n) -> bool {
+    auto& incoming = n.incoming[n.channel];
+    auto& counters = n.com.counters[n.channel];
+    auto const burst = m_config.burst_us > 0;
+    packet pkt{};
+    pkt.channel = n.channel;
+    auto flush = [&] {
+        if (pkt.size == 0) return;
+        ++counters.packets_in;
+        counters.bytes_in += pkt.size;
+        n.com.in[n.channel].enq(pkt);
+        pkt.size = 0;
+    };
+    // Reading once at the slot end, past the receive buffer is lost and past the packet is
+    // dropped when the serial ends. In burst mode multicom drains the serial while listening.
+    auto const capacity = burst ? SIZE_MAX : std::min(m_config.rx_buffer, sizeof(pkt.data));
+    std::size_t buffered = 0;
+    for (auto& tx : incoming) {
+        for (; tx.next < tx.size && tx.start + byte_time(tx.next + 1u) < n.now; ++tx.next) {
+            auto const arrival = tx.start + byte_time(tx.next + 1u);
+            if (arrival < n.slot_start || buffered == capacity) {
+                ++part.bytes_lost;
+                continue;
+            }
+            pkt.data[pkt.size++] = tx.data[tx.next];
+            ++buffered;
+            if (pkt.size == sizeof(pkt.data)) flush();
+        }
+    }
+    flush();
+    // Whatever has not fully arrived stays for a later slot on this channel
+    incoming.erase(std::remove_if(incoming.begin(), incoming.end(), [](transmission const& tx) {
+        return tx.next == tx.size;
+    }), incoming.end());
+    return buffered > 0;
+}
+
+auto mesh::linger(sim_node const& n) const -> uint64_t {
+    if (n.scheduler->linger_us() == 0) return 0;
+    auto const limit = std::max(n.scheduler->linger_us(), m_config.burst_us);
+    // The packet in progress and any sent straight after it, the board sees a steady stream
+    uint64_t until = 0;
+    for (auto const& tx : n.incoming[n.channel]) {
+        auto const first = tx.start + byte_time(1);
+        auto const last  = tx.start + byte_time(tx.size);
+        if (first < n.slot_start) continue;
+        if (until == 0) {
+            if (first < n.now && last >= n.now) until = last + 1;
+        } else if (first <= until + byte_time(2)) {
+            until = std::max(until, last + 1);
+        }
+    }
+    return std::min(until, n.now + limit);
+}
+
+auto mesh::transmit(partition& part, sim_node& n) -> uint64_t {
+    auto& out = n.com.out[n.channel];
+    auto& counters = n.com.counters[n.channel];
+    auto const peer = n.peer[n.channel];
+    uint64_t elapsed = 0;
+    ++part.send_slots;
+    // One packet, or in burst mode as many as fit back to back
+    do {
+        auto const& pkt = out.front();
+        if (peer < size()) {
+            transmission tx{};
+            tx.start = n.now + elapsed;
+            tx.size  = pkt.size;
+            std::memcpy(tx.data, pkt.data, pkt.size);
+            auto const channel = n.peer_channel[n.channel];
+            auto const target  = m_partition_of[peer];
+            // Another partition's nodes are only touched by its own thread, it picks these up after the window
+            if (&m_partitions[target] == &part) {
+                m_nodes[peer].incoming[channel].push_back(tx);
+            } else {
+                part.outbox[target].push_back({peer, channel, tx});
+            }
+        } else {
+            part.bytes_lost += pkt.size;
+        }
+        elapsed += byte_time(pkt.size);
+        ++part.packets_sent;
+        ++counters.packets_out;
+        counters.bytes_out += pkt.size;
+        out.pop();
+    } while (m_config.burst_us > 0 && !out.empty() && elapsed + byte_time(out.front().size) <= m_config.burst_us);
+    return elapsed;
+}
+
+auto mesh::run_node(partition& part, sim_node& n) -> void {
+    auto& light = n.light;
+    light.loop();
+
+    auto const now = to_signed(n.now);
+    if (light.addresses().size() != n.addresses) {
+        n.addresses = light.addresses().size();
+        part.topology_us = std::max(part.topology_us, now);
+    }
+    if (light.exit_count() != n.exits) {
+        n.exits = light.exit_count();
+        part.exits_us = std::max(part.exits_us, now);
+        if (n.exit_known == never) n.exit_known = n.now;
+    }
+    if (n.edges_done == never) {
+        bool done = true;
+        for (std::size_t i = 0; i < MAX_CHANNEL; ++i) {
+            if (n.peer[i] < size() && !light.is_edge_verified(i)) done = false;
+        }
+        if (done) n.edges_done = n.now;
+    }
+    if (n.on_fire == never && light.state() == node_state::fire) n.on_fire = n.now;
+}
+
+auto mesh::report() const -> mesh_report {
+    mesh_report result{};
+    result.now_us = m_now;
+    result.wall_seconds = m_wall_seconds;
+    result.windows = m_windows;
+    for (auto const& part : m_partitions) {
+        result.events       += part.events_run;
+        result.packets_sent += part.packets_sent;
+        result.send_slots   += part.send_slots;
+        result.bytes_lost   += part.bytes_lost;
+        result.topology_us   = std::max(result.topology_us, part.topology_us);
+        result.exits_us      = std::max(result.exits_us, part.exits_us);
+    }
+
+    uint64_t drain_total = 0;
+    uint64_t drains      = 0;
+    for (auto const& part : m_partitions) {
+        drain_total += part.drain_total;
+        drains      += part.drains;
+    }
+    if (drains > 0) result.mean_drain_us = to_signed(drain_total / drains);
+
+    uint64_t edges_done = 0;
+    uint64_t exit_known = 0;
+    uint64_t fire_at    = never;
+    uint64_t last_fire  = 0;
+    for (auto const& n : m_nodes) {
+        result.frames += n.light.frames_received();
+        result.topology_writes += n.com.topology_writes;
+        for (auto const& out : n.com.out) {
+            result.suppressed += out.suppressed();
+            result.evicted    += out.evicted();
+        }
+        edges_done = std::max(edges_done, n.edges_done);
+        exit_known = std::max(exit_known, n.exit_known);
+        if (n.pins.fire) fire_at = std::min(fire_at, n.fire_at);
+        if (n.on_fire != never) {
+            ++result.fire_nodes;
+            last_fire = std::max(last_fire, n.on_fire);
+        }
+    }
+    if (!m_nodes.empty() && edges_done != never) result.edges_verified_us = to_signed(edges_done);
+    if (!m_nodes.empty() && exit_known != never) result.exit_reached_us = to_signed(exit_known);
+    if (fire_at != never) {
+        result.fire_us = to_signed(fire_at);
+        if (result.fire_nodes > 0) result.fire_spread_us = to_signed(last_fire) - result.fire_us;
+    }
+    if (result.wall_seconds > 0.0) result.frames_per_second = static_cast<double>(result.frames) / result.wall_seconds;
+    return result;
+}
+
+auto mesh::topology_coverage() const -> double {
+    std::size_t known = 0;
+    std::size_t total = 0;
+    for (auto const& viewer : m_nodes) {
+        auto const& addresses = viewer.light.addresses();
+        auto const& topo = viewer.light.topology();
+        for (auto const& n : m_nodes) {
+            auto const from = addresses.find(n.light.address());
+            for (std::size_t i = 0; i < MAX_CHANNEL; ++i) {
+                if (n.peer[i] >= size() || !n.light.is_edge_verified(i)) continue;
+                ++total;
+                auto const to = addresses.find(m_nodes[n.peer[i]].light.address());
+                if (from != addresses.npos && to != addresses.npos && topo.matrix[from][to] > 0) ++known;
+            }
+        }
+    }
+    return total == 0 ? 0.0 : static_cast<double>(known) / static_cast<double>(total);
+}
+
+auto make_grid_mesh(std::size_t width, std::size_t height, mesh_config const& config) -> std::unique_ptr<mesh> {
+    auto result = std::make_unique<mesh>(width * height, config);
+    for (std::size_t y = 0; y < height; ++y) {
+        for (std::size_t x = 0; x < width; ++x) {
+            auto const i = y * width + x;
+            if (x + 1 < width)  result->connect(i, 1, i + 1, 3);
+            if (y + 1 < height) result->connect(i, 2, i + width, 0);
+        }
+    }
+    return result;
+}
+} // namespace ray
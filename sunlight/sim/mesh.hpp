@@ -0,0 +1,284 @@
+/**
+ * @file   mesh.hpp
+ * @author Pratchaya Khansomboon (me@mononerv.dev)
+ * @brief  Discrete-event simulation of a mesh of sunlight nodes.
+ * @date   2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ */
+#ifndef SUNLIGHT_SIM_MESH_HPP
+#define SUNLIGHT_SIM_MESH_HPP
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <queue>
+#include <thread>
+#include <vector>
+
+#include "sky.hpp"
+#include "hal.hpp"
+#include "node.hpp"
+#include "trace.hpp"
+#include "scheduler.hpp"
+#include "out_queue.hpp"
+
+namespace ray {
+enum class mesh_schedule {
+    round_robin,  // multicom as it always ran
+    adaptive,
+};
+
+struct mesh_config {
+    uint32_t baud         = 9600;   // SOFTWARE_BAUD, 10 bits per byte on the wire
+    uint32_t slot_min_us  = 16000;  // multicom listens random(16, 66) ms per channel
+    uint32_t slot_max_us  = 66000;
+    mesh_schedule schedule = mesh_schedule::round_robin;
+    uint32_t burst_us     = 0;      // Longest back to back send in one slot, 0 sends one packet
+    bool     coalesce     = false;  // Merge writes of a packet already queued, see out_queue
+    bool     priority     = false;  // Fire and reset frames first, see out_queue
+    bool     link_state   = false;  // Versioned topology gossip, see node::set_link_state
+    uint64_t boot_max_us  = 500000; // Nodes power up at a random time below this
+    std::size_t rx_buffer = 64;     // SoftwareSerial receive buffer
+    uint64_t seed         = 1;
+    std::size_t threads   = 1;      // Worker threads, the result does not depend on it
+};
+
+// Times are virtual microseconds, -1 when it did not happen.
+struct mesh_report {
+    uint64_t now_us         = 0;
+    double   wall_seconds   = 0.0;
+    uint64_t events         = 0;
+    uint64_t windows        = 0;  // Synchronisation rounds between the threads
+    uint64_t packets_sent   = 0;
+    uint64_t send_slots     = 0;  // Slots that ended in a send, a burst is one
+    uint64_t bytes_lost     = 0;  // Sent while the other end listened elsewhere or was full
+    uint64_t suppressed     = 0;  // Writes merged into a queued packet
+    uint64_t evicted        = 0;  // Queued packets lost to a write on a full out queue
+    uint64_t topology_writes = 0; // Topology frames written, flooded ones or adverts and digests
+    uint64_t frames         = 0;  // Whole frames handled by all nodes
+    double   frames_per_second = 0.0;  // Per wall clock second
+
+    int64_t  edges_verified_us = -1;  // Every wired channel of every node verified
+    int64_t  topology_us       = -1;  // Last time any node learnt a new address, of host_node::max_nodes at most
+    int64_t  exits_us          = -1;  // Last time any node learnt a new exit
+    int64_t  exit_reached_us   = -1;  // Every node knows of an exit
+    int64_t  mean_drain_us     = -1;  // Out queue seen non-empty at a slot end until seen empty
+    int64_t  fire_us           = -1;  // First fire switch
+    int64_t  fire_spread_us    = -1;  // Last node to go into fire mode, after fire_us
+    std::size_t fire_nodes     = 0;   // Nodes in fire mode
+};
+
+/**
+ * @brief N ray::host_node instances wired channel to channel and driven by virtual time.
+ *        They run the board's logic with room for a 16x16 grid instead of 16 lights.
+ *
+ *        Every node's multicom is modelled the way it runs on the board: listen on one
+ *        channel for a random slot, then either read what arrived, at most one packet,
+ *        or transmit the front of that channel's out queue and block until it is on the
+ *        wire. Bytes arrive at the baud rate and are only received if the other end
+ *        listens on that channel at the time, everything else is lost like on the board.
+ *
+ *        The only events are slot ends, so virtual time advances as fast as the nodes can
+ *        be run. With several threads the nodes are split into index ranges, one partition
+ *        per thread, run in time windows. A node only sends on a channel at the end of a
+ *        slot on it and a slot is at least slot_min_us, so the first byte a partition can
+ *        put on another's wire is known ahead. Windows end there, nothing in a window can
+ *        depend on another partition's work in the same window and the result is the same
+ *        for any thread count.
+ */
+class mesh {
+public:
+    explicit mesh(std::size_t node_count, mesh_config const& config = {});
+    ~mesh();
+    mesh(mesh const&) = delete;
+    mesh& operator=(mesh const&) = delete;
+
+    // Wire channel a_channel of a to b_channel of b, false if either is in use.
+    auto connect(std::size_t a, uint8_t a_channel, std::size_t b, uint8_t b_channel) -> bool;
+    auto set_exit(std::size_t index) -> void;
+    // Flip the fire switch of the node at the given virtual time.
+    auto set_fire(std::size_t index, uint64_t at_us) -> void;
+    // Trace what the node reads and writes, the recorder is called on the node's thread.
+    auto set_recorder(std::size_t index, recorder* rec) -> void;
+    [[nodiscard]] auto counters(std::size_t index, uint8_t channel) const -> channel_counters;
+
+    // Run every event up to and including end_us.
+    auto run_until(uint64_t end_us) -> void;
+
+    [[nodiscard]] auto now() const noexcept -> uint64_t { return m_now; }
+    [[nodiscard]] auto size() const noexcept -> std::size_t { return m_nodes.size(); }
+    [[nodiscard]] auto at(std::size_t index) const -> ray::host_node const& { return m_nodes[index].light; }
+    [[nodiscard]] auto report() const -> mesh_report;
+    // Share of the edges verified so far that the nodes have in their topology, averaged over
+    // the nodes. 1 when every node knows them all, only possible up to host_node::max_nodes nodes.
+    [[nodiscard]] auto topology_coverage() const -> double;
+
+private:
+    struct sim_clock : ray::clock {
+        sim_clock(uint64_t const& now_us, uint64_t boot_us) : now(now_us), boot(boot_us) {}
+        uint64_t const& now;
+        uint64_t        boot;
+        auto millis() const -> uint32_t override;
+    };
+    struct sim_chip : ray::chip {
+        explicit sim_chip(uint32_t address) : value(address) {}
+        uint32_t value;
+        auto id() const -> uint32_t override { return value; }
+    };
+    // Same queues as multicom, the slots are run by the mesh.
+    struct sim_channels : ray::channels {
+        explicit sim_channels(sim_clock const& node_clock) : clock(node_clock) {}
+        sim_clock const& clock;
+        recorder* trace = nullptr;
+        channel_counters counters[MAX_CHANNEL]{};
+        uint64_t topology_writes = 0;
+        sky::queue<packet, MAX_QUEUE> in[MAX_CHANNEL];
+        out_queue out[MAX_CHANNEL];
+        auto poll() -> void override {}
+        auto write(packet const& pkt) noexcept -> void override;
+        auto read(uint8_t channel) noexcept -> packet override;
+        auto clear_buffer(uint8_t channel) noexcept -> void override;
+        auto overwritten(uint8_t channel) const noexcept -> std::size_t override;
+    };
+    struct sim_leds : ray::leds {
+        auto set_pixel(std::size_t, uint32_t) -> void override {}
+        auto show() -> void override {}
+    };
+    struct sim_pins : ray::config_pins {
+        bool reset = false;
+        bool fire  = false;
+        bool exit  = false;
+        auto is_reset() const -> bool override { return reset; }
+        auto is_fire() const -> bool override { return fire; }
+        auto is_exit() const -> bool override { return exit; }
+    };
+
+    // Bytes on their way to a channel, byte i arrives at start + (i + 1) * byte time.
+    struct transmission {
+        uint64_t start = 0;
+        uint8_t  size  = 0;
+        uint8_t  next  = 0;  // Bytes before next are received or lost already
+        uint8_t  data[sizeof(packet::data)]{};
+    };
+
+    static constexpr uint64_t never = UINT64_MAX;
+
+    struct sim_node {
+        sim_node(uint32_t address, uint64_t boot, std::unique_ptr<channel_scheduler> slots);
+
+        uint64_t     now = 0;  // Time of the slot end being run
+        sim_clock    clock;
+        sim_chip     chip;
+        sim_channels com;
+        sim_leds     leds;
+        sim_pins     pins;
+        ray::host_node light;
+
+        // Wiring, peer index is the node count when the channel is free
+        std::size_t peer[MAX_CHANNEL]{};
+        uint8_t     peer_channel[MAX_CHANNEL]{};
+        std::vector<transmission> incoming[MAX_CHANNEL];
+
+        // Current multicom slot, listening on channel in [slot_start, wake)
+        uint8_t  channel    = 0;
+        uint64_t slot_start = 0;
+        uint64_t wake       = 0;
+        bool     lingered   = false;  // The slot end was put off once already
+        std::unique_ptr<channel_scheduler> scheduler;
+        uint64_t fire_at    = never;  // Fire switch, seen on the first slot end after it
+
+        // What the report is built from
+        std::size_t addresses = 0;
+        std::size_t exits     = 0;
+        uint64_t edges_done   = never;
+        uint64_t exit_known   = never;
+        uint64_t queued_since[MAX_CHANNEL]{never, never, never, never};
+        uint64_t on_fire      = never;
+    };
+
+    struct event {
+        uint64_t    time;
+        std::size_t node;
+        auto operator>(event const& other) const -> bool {
+            return time != other.time ? time > other.time : node > other.node;
+        }
+    };
+
+    // A transmission to a node of another partition.
+    struct delivery {
+        std::size_t  node;
+        uint8_t      channel;
+        transmission tx;
+    };
+
+    struct partition {
+        std::size_t begin = 0;
+        std::size_t end   = 0;
+        std::priority_queue<event, std::vector<event>, std::greater<event>> events{};
+        std::vector<std::size_t> boundary{};  // Nodes wired to another partition
+        // One mailbox per target partition, filled during a window and emptied by the target
+        // before the next. The window barriers keep the two apart so they need no locks.
+        std::vector<std::vector<delivery>> outbox{};
+        uint64_t horizon = never;  // First byte this partition can put on another's wire
+        uint64_t next    = never;  // First event
+
+        uint64_t events_run   = 0;
+        uint64_t packets_sent = 0;
+        uint64_t send_slots   = 0;
+        uint64_t bytes_lost   = 0;
+        uint64_t drain_total  = 0;
+        uint64_t drains       = 0;
+        int64_t  topology_us  = -1;
+        int64_t  exits_us     = -1;
+    };
+
+    // Reusable barrier for the window rounds, spins a little then yields.
+    class barrier {
+    public:
+        explicit barrier(std::size_t count) : m_count(count) {}
+        auto arrive_and_wait() -> void;
+
+    private:
+        std::size_t m_count;
+        std::atomic<std::size_t> m_waiting{0};
+        std::atomic<std::size_t> m_generation{0};
+    };
+
+    auto partition_nodes() -> void;
+    auto start_workers() -> void;
+    auto run_partition(std::size_t index, uint64_t end_us) -> void;
+    auto deliver(std::size_t index) -> void;
+    auto horizon(partition const& part) const -> uint64_t;
+
+    auto slot_end(partition& part, std::size_t index) -> void;
+    auto receive(partition& part, sim_node& n) -> bool;
+    auto linger(sim_node const& n) const -> uint64_t;
+    auto transmit(partition& part, sim_node& n) -> uint64_t;
+    auto next_slot(sim_node& n, uint64_t start, slot next) -> void;
+    auto run_node(partition& part, sim_node& n) -> void;
+    auto byte_time(std::size_t bytes) const -> uint64_t;
+
+private:
+    mesh_config m_config;
+    uint64_t m_now = 0;
+    std::deque<sim_node> m_nodes;
+    std::vector<std::size_t> m_partition_of;
+    std::vector<partition> m_partitions;
+    bool m_partitioned = false;
+
+    // Shared by the threads in run_until, partition 0 runs on the caller
+    std::unique_ptr<barrier> m_barrier;
+    std::vector<std::thread> m_workers;
+    std::atomic<bool> m_stop{false};
+    uint64_t m_end = 0;
+    uint64_t m_windows = 0;
+    double m_wall_seconds = 0.0;
+};
+
+// width * height nodes in rows, channel 0 up, 1 right, 2 down and 3 left.
+auto make_grid_mesh(std::size_t width, std::size_t height, mesh_config const& config = {}) -> std::unique_ptr<mesh>;
+} // namespace ray
+
+#endif  // !SUNLIGHT_SIM_MESH_HPP
@@ -0,0 +1,229 @@
+/**
+ * @file   meshsim.cpp
+ * @author Pratchaya Khansomboon (me@mononerv.dev)
+ * @brief  Headless mesh simulator, runs sunlight nodes in virtual time and reports how the mesh behaves.
+ * @date   2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * meshsim [--grid WxH | --graph FILE] [--exit N]... [--fire N@MS]... [--until MS]
+ *         [--baud BAUD] [--boot MS] [--seed SEED] [--threads N] [--schedule round_robin|adaptive]
+ *         [--burst MS] [--coalesce on|off] [--priority on|off] [--gossip flood|link_state]
+ *         [--record N@FILE]...
+ *
+ * A graph file has one link per line, "a a_channel b b_channel", # starts a comment.
+ * --record writes what node N reads and writes to FILE, replay it with tracereplay.
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "fmt/format.h"
+#include "mesh.hpp"
+#include "trace_file.hpp"
+
+namespace {
+struct link {
+    std::size_t a;
+    unsigned    a_channel;
+    std::size_t b;
+    unsigned    b_channel;
+};
+
+struct fire {
+    std::size_t node;
+    uint64_t    at_ms;
+};
+
+struct record {
+    std::size_t node;
+    std::string path;
+};
+
+struct options {
+    std::size_t width  = 10;
+    std::size_t height = 10;
+    std::string graph{};
+    std::vector<std::size_t> exits{};
+    std::vector<fire> fires{};
+    std::vector<record> records{};
+    uint64_t until_ms = 60'000;
+    ray::mesh_config config{};
+};
+
+auto usage() -> int {
+    fmt::print(stderr, "usage: meshsim [--grid WxH | --graph FILE] [--exit N]... [--fire N@MS]... [--until MS]\n"
+                       "               [--baud BAUD] [--boot MS] [--seed SEED] [--threads N] [--schedule round_robin|adaptive]\n"
+                       "               [--burst MS] [--coalesce on|off] [--priority on|off] [--gossip flood|link_state]\n"
+                       "               [--record N@FILE]...\n");
+    return 1;
+}
+
+auto parse(int argc, char const* argv[], options& opts) -> bool {
+    for (int i = 1; i < argc; ++i) {
+        std::string const arg = argv[i];
+        if (i + 1 >= argc) return false;
+        char const* value = argv[++i];
+        if (arg == "--grid") {
+            if (std::sscanf(value, "%zux%zu", &opts.width, &opts.height) != 2) return false;
+        } else if (arg == "--graph") {
+            opts.graph = value;
+        } else if (arg == "--exit") {
+            opts.exits.push_back(std::strtoull(value, nullptr, 10));
+        } else if (arg == "--fire") {
+            fire f{};
+            unsigned long long at = 0;
+            if (std::sscanf(value, "%zu@%llu", &f.node, &at) != 2) return false;
+            f.at_ms = at;
+            opts.fires.push_back(f);
+        } else if (arg == "--schedule") {
+            std::string const name = value;
+            if (name == "round_robin") {
+                opts.config.schedule = ray::mesh_schedule::round_robin;
+            } else if (name == "adaptive") {
+                opts.config.schedule = ray::mesh_schedule::adaptive;
+            } else {
+                return false;
+            }
+        } else if (arg == "--burst") {
+            opts.config.burst_us = static_cast<uint32_t>(std::strtoul(value, nullptr, 10) * 1000);
+        } else if (arg == "--coalesce") {
+            std::string const mode = value;
+            if (mode != "on" && mode != "off") return false;
+            opts.config.coalesce = mode == "on";
+        } else if (arg == "--priority") {
+            std::string const mode = value;
+            if (mode != "on" && mode != "off") return false;
+            opts.config.priority = mode == "on";
+        } else if (arg == "--gossip") {
+            std::string const mode = value;
+            if (mode != "flood" && mode != "link_state") return false;
+            opts.config.link_state = mode == "link_state";
+        } else if (arg == "--record") {
+            std::string const spec = value;
+            auto const at = spec.find('@');
+            if (at == std::string::npos || at == 0 || at + 1 == spec.size()) return false;
+            opts.records.push_back({std::strtoull(spec.substr(0, at).c_str(), nullptr, 10), spec.substr(at + 1)});
+        } else if (arg == "--until") {
+            opts.until_ms = std::strtoull(value, nullptr, 10);
+        } else if (arg == "--baud") {
+            opts.config.baud = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+            if (opts.config.baud == 0) return false;
+        } else if (arg == "--boot") {
+            opts.config.boot_max_us = std::strtoull(value, nullptr, 10) * 1000;
+        } else if (arg == "--seed") {
+            opts.config.seed = std::strtoull(value, nullptr, 10);
+        } else if (arg == "--threads") {
+            opts.config.threads = std::strtoull(value, nullptr, 10);
+            if (opts.config.threads == 0) return false;
+        } else {
+            return false;
+        }
+    }
+    if (opts.exits.empty()) opts.exits.push_back(0);
+    return true;
+}
+
+auto load_graph(std::string const& path, ray::mesh_config const& config) -> std::unique_ptr<ray::mesh> {
+    std::ifstream file(path);
+    if (!file) return nullptr;
+    std::vector<link> links{};
+    std::size_t count = 0;
+    for (std::string line; std::getline(file, line);) {
+        line = line.substr(0, line.find('#'));
+        std::istringstream stream(line);
+        link l{};
+        if (!(stream >> l.a >> l.a_channel >> l.b >> l.b_channel)) continue;
+        links.push_back(l);
+        count = std::max(count, std::max(l.a, l.b) + 1);
+    }
+    auto result = std::make_unique<ray::mesh>(count, config);
+    for (auto const& l : links) {
+        if (!result->connect(l.a, static_cast<uint8_t>(l.a_channel), l.b, static_cast<uint8_t>(l.b_channel))) {
+            fmt::print(stderr, "skipped link {} {} {} {}\n", l.a, l.a_channel, l.b, l.b_channel);
+        }
+    }
+    return result;
+}
+
+auto ms(int64_t us) -> std::string {
+    if (us < 0) return "-";
+    return fmt::format("{:.1f} ms", static_cast<double>(us) / 1000.0);
+}
+} // namespace
+
+auto main(int argc, char const* argv[]) -> int {
+    options opts{};
+    if (!parse(argc, argv, opts)) return usage();
+
+    auto sim = opts.graph.empty() ? ray::make_grid_mesh(opts.width, opts.height, opts.config)
+                                  : load_graph(opts.graph, opts.config);
+    if (!sim) {
+        fmt::print(stderr, "could not read {}\n", opts.graph);
+        return 1;
+    }
+    for (auto const exit : opts.exits) sim->set_exit(exit);
+    for (auto const& f : opts.fires) sim->set_fire(f.node, f.at_ms * 1000);
+
+    std::vector<std::unique_ptr<ray::trace_writer>> traces{};
+    for (auto const& r : opts.records) {
+        if (r.node >= sim->size()) continue;
+        auto writer = std::make_unique<ray::trace_writer>(r.path, sky::mcp_address_to_u32(sim->at(r.node).address()));
+        if (!writer->is_open()) {
+            fmt::print(stderr, "could not write {}\n", r.path);
+            return 1;
+        }
+        sim->set_recorder(r.node, writer.get());
+        traces.push_back(std::move(writer));
+    }
+
+    sim->run_until(opts.until_ms * 1000);
+
+    auto const report = sim->report();
+    fmt::print("nodes:            {}\n", sim->size());
+    fmt::print("virtual time:     {}\n", ms(static_cast<int64_t>(report.now_us)));
+    fmt::print("wall time:        {:.3f} s ({:.0f}x real time)\n", report.wall_seconds,
+               report.wall_seconds > 0.0 ? static_cast<double>(report.now_us) / 1e6 / report.wall_seconds : 0.0);
+    fmt::print("events:           {} in {} windows\n", report.events, report.windows);
+    fmt::print("packets sent:     {} in {} slots ({:.2f} per slot)\n", report.packets_sent, report.send_slots,
+               report.send_slots > 0 ? static_cast<double>(report.packets_sent) / static_cast<double>(report.send_slots) : 0.0);
+    fmt::print("out queue drain:  {} on average\n", ms(report.mean_drain_us));
+    fmt::print("out queue writes: {} merged, {} packets evicted\n", report.suppressed, report.evicted);
+    fmt::print("bytes lost:       {}\n", report.bytes_lost);
+    fmt::print("frames handled:   {} ({:.0f} frames/s)\n", report.frames, report.frames_per_second);
+    fmt::print("edges verified:   {}\n", ms(report.edges_verified_us));
+    // Discovery only converges when every node has room for the whole mesh
+    if (sim->size() <= ray::host_node::max_nodes) {
+        fmt::print("last new address: {}\n", ms(report.topology_us));
+        fmt::print("topology known:   {:.1f} % of the verified edges\n", sim->topology_coverage() * 100.0);
+    } else {
+        fmt::print("last new address: - (a node keeps {} of {} addresses)\n", ray::host_node::max_nodes, sim->size());
+        fmt::print("topology known:   -\n");
+    }
+    fmt::print("topology writes:  {}\n", report.topology_writes);
+    fmt::print("last new exit:    {}\n", ms(report.exits_us));
+    fmt::print("exit reached all: {}\n", ms(report.exit_reached_us));
+    fmt::print("fire at:          {}\n", ms(report.fire_us));
+    fmt::print("fire spread:      {} to {} of {} nodes\n", ms(report.fire_spread_us), report.fire_nodes, sim->size());
+    for (uint8_t ch = 0; ch < ray::MAX_CHANNEL; ++ch) {
+        ray::channel_counters total{};
+        std::size_t deepest = 0;
+        for (std::size_t i = 0; i < sim->size(); ++i) {
+            auto const c = sim->counters(i, ch);
+            total.slots       += c.slots;
+            total.packets_in  += c.packets_in;
+            total.bytes_in    += c.bytes_in;
+            total.packets_out += c.packets_out;
+            total.bytes_out   += c.bytes_out;
+            deepest = std::max(deepest, c.out_depth);
+        }
+        auto const seconds = static_cast<double>(report.now_us) / 1e6;
+        fmt::print("channel {}:        {} slots, in {:.0f} B/s, out {:.0f} B/s, deepest out queue {}\n", ch, total.slots,
+                   seconds > 0.0 ? total.bytes_in / seconds : 0.0, seconds > 0.0 ? total.bytes_out / seconds : 0.0, deepest);
+    }
+    return 0;
+}
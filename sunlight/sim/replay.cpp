@@ -0,0 +1,54 @@
+/**
+ * @file   replay.cpp
+ * @author Pratchaya Khansomboon (me@mononerv.dev)
+ * @brief  Feeds a recorded trace into a host-built node as fast as it can be run.
+ * @date   2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ */
+#include "replay.hpp"
+#include <chrono>
+
+namespace ray {
+auto replayer::replay_channels::read(uint8_t channel) noexcept -> packet {
+    if (channel >= MAX_CHANNEL || in[channel].empty()) return {};
+    auto const pkt = in[channel].front();
+    in[channel].pop_front();
+    return pkt;
+}
+
+auto replayer::replay_channels::clear_buffer(uint8_t channel) noexcept -> void {
+    if (channel < MAX_CHANNEL) in[channel].clear();
+}
+
+replayer::replayer(uint32_t address) : m_chip(address), m_light({m_clock, m_chip, m_com, m_leds, m_pins, nullptr}) {
+    m_light.setup();
+}
+
+auto replayer::run(trace_file const& trace) -> replay_report {
+    replay_report result{};
+    auto const wall_start = std::chrono::steady_clock::now();
+    auto const frames_before = m_light.frames_received();
+    auto const sent_before = m_com.sent;
+
+    trace_record rec{};
+    for (auto records = trace.records(); records.next(rec);) {
+        ++result.records;
+        result.last_ms = rec.time;
+        if (rec.sent) {
+            ++result.sent_recorded;
+            continue;
+        }
+        ++result.received;
+        m_clock.now = rec.time;
+        m_com.in[rec.pkt.channel].push_back(rec.pkt);
+        m_light.loop();
+    }
+
+    result.frames = m_light.frames_received() - frames_before;
+    result.sent = m_com.sent - sent_before;
+    result.wall_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+    if (result.wall_seconds > 0.0) result.frames_per_second = static_cast<double>(result.frames) / result.wall_seconds;
+    return result;
+}
+} // namespace ray
@@ -0,0 +1,94 @@
+/**
+ * @file   replay.hpp
+ * @author Pratchaya Khansomboon (me@mononerv.dev)
+ * @brief  Feeds a recorded trace into a host-built node as fast as it can be run.
+ * @date   2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ */
+#ifndef SUNLIGHT_SIM_REPLAY_HPP
+#define SUNLIGHT_SIM_REPLAY_HPP
+#include <cstdint>
+#include <cstddef>
+#include <deque>
+
+#include "hal.hpp"
+#include "node.hpp"
+#include "trace.hpp"
+#include "trace_file.hpp"
+
+namespace ray {
+struct replay_report {
+    std::size_t records       = 0;
+    std::size_t received      = 0;  // Packets fed to the node
+    std::size_t sent_recorded = 0;  // Packets the node wrote when the trace was taken
+    std::size_t sent          = 0;  // Packets the node wrote in the replay
+    uint64_t    frames        = 0;
+    uint32_t    last_ms       = 0;  // Node time of the last record
+    double      wall_seconds  = 0.0;
+    double      frames_per_second = 0.0;  // Per wall clock second
+};
+
+/**
+ * @brief One node on a fake hal whose clock follows the trace. Every received record sets
+ *        the clock to its time, queues the packet on its channel and runs the node once.
+ *        What the node writes is counted and dropped. Frames are rebuilt from the same
+ *        bytes in the same order, so the replayed node handles the same frames as the
+ *        recorded one did.
+ */
+class replayer {
+public:
+    explicit replayer(uint32_t address);
+    replayer(replayer const&) = delete;
+    replayer& operator=(replayer const&) = delete;
+
+    // Set before run, the trace does not record the switches.
+    auto set_exit(bool exit) noexcept -> void { m_pins.exit = exit; }
+    auto set_fire(bool fire) noexcept -> void { m_pins.fire = fire; }
+
+    auto run(trace_file const& trace) -> replay_report;
+
+    [[nodiscard]] auto light() const noexcept -> ray::node const& { return m_light; }
+
+private:
+    struct replay_clock : ray::clock {
+        uint32_t now = 0;
+        auto millis() const -> uint32_t override { return now; }
+    };
+    struct replay_chip : ray::chip {
+        explicit replay_chip(uint32_t address) : value(address) {}
+        uint32_t value;
+        auto id() const -> uint32_t override { return value; }
+    };
+    struct replay_channels : ray::channels {
+        std::deque<packet> in[MAX_CHANNEL];
+        std::size_t sent = 0;
+        auto poll() -> void override {}
+        auto write(packet const&) noexcept -> void override { ++sent; }
+        auto read(uint8_t channel) noexcept -> packet override;
+        auto clear_buffer(uint8_t channel) noexcept -> void override;
+        auto overwritten(uint8_t) const noexcept -> std::size_t override { return 0; }
+    };
+    struct replay_leds : ray::leds {
+        auto set_pixel(std::size_t, uint32_t) -> void override {}
+        auto show() -> void override {}
+    };
+    struct replay_pins : ray::config_pins {
+        bool fire = false;
+        bool exit = false;
+        auto is_reset() const -> bool override { return false; }
+        auto is_fire() const -> bool override { return fire; }
+        auto is_exit() const -> bool override { return exit; }
+    };
+
+private:
+    replay_clock    m_clock{};
+    replay_chip     m_chip;
+    replay_channels m_com{};
+    replay_leds     m_leds{};
+    replay_pins     m_pins{};
+    ray::node       m_light;
+};
+} // namespace ray
+
+#endif  // !SUNLIGHT_SIM_REPLAY_HPP
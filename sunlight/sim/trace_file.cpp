@@ -0,0 +1,85 @@
+/**
+ * @file   trace_file.cpp
+ * @author Pratchaya Khansomboon (me@mononerv.dev)
+ * @brief  Node traces on disk, written through the recorder hook and memory-mapped for reading.
+ * @date   2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ */
+#include "trace_file.hpp"
+#include <fstream>
+#include <iterator>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SUNLIGHT_TRACE_MMAP
+#endif
+
+namespace ray {
+trace_writer::trace_writer(std::string const& path, uint32_t address) : m_file(std::fopen(path.c_str(), "wb")) {
+    if (m_file == nullptr) return;
+    uint8_t header[trace_header_size];
+    std::fwrite(header, 1, encode_trace_header(header, address), m_file);
+}
+
+trace_writer::~trace_writer() {
+    if (m_file != nullptr) std::fclose(m_file);
+}
+
+auto trace_writer::record(trace_record const& rec) noexcept -> void {
+    if (m_file == nullptr) return;
+    uint8_t buffer[trace_record_max];
+    std::fwrite(buffer, 1, encode_trace_record(buffer, rec), m_file);
+    ++m_records;
+}
+
+trace_file::trace_file(std::string const& path) {
+#ifdef SUNLIGHT_TRACE_MMAP
+    auto const fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return;
+    struct stat info{};
+    if (::fstat(fd, &info) == 0 && info.st_size > 0) {
+        auto const size = static_cast<std::size_t>(info.st_size);
+        auto* data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data != MAP_FAILED) {
+            // Records are read front to back once
+            ::madvise(data, size, MADV_SEQUENTIAL);
+            m_data   = static_cast<uint8_t const*>(data);
+            m_size   = size;
+            m_mapped = true;
+        }
+    }
+    ::close(fd);
+#else
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return;
+    m_copy.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    m_data = m_copy.data();
+    m_size = m_copy.size();
+#endif
+    m_valid = m_data != nullptr && decode_trace_header(m_data, m_size, m_address);
+}
+
+trace_file::~trace_file() {
+#ifdef SUNLIGHT_TRACE_MMAP
+    if (m_mapped) ::munmap(const_cast<uint8_t*>(m_data), m_size);
+#endif
+}
+
+trace_file::cursor::cursor(trace_file const& file) noexcept
+    : m_data(file.m_data), m_size(file.m_valid ? file.m_size : 0), m_offset(trace_header_size) {}
+
+auto trace_file::cursor::next(trace_record& rec) noexcept -> bool {
+    if (m_offset >= m_size) return false;
+    auto const used = decode_trace_record(m_data + m_offset, m_size - m_offset, rec);
+    if (used == 0) {
+        m_offset = m_size;
+        return false;
+    }
+    m_offset += used;
+    return true;
+}
+} // namespace ray
@@ -0,0 +1,76 @@
+/**
+ * @file   trace_file.hpp
+ * @author Pratchaya Khansomboon (me@mononerv.dev)
+ * @brief  Node traces on disk, written through the recorder hook and memory-mapped for reading.
+ * @date   2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ */
+#ifndef SUNLIGHT_SIM_TRACE_FILE_HPP
+#define SUNLIGHT_SIM_TRACE_FILE_HPP
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "trace.hpp"
+
+namespace ray {
+class trace_writer : public recorder {
+public:
+    trace_writer(std::string const& path, uint32_t address);
+    ~trace_writer() override;
+    trace_writer(trace_writer const&) = delete;
+    trace_writer& operator=(trace_writer const&) = delete;
+
+    auto record(trace_record const& rec) noexcept -> void override;
+
+    [[nodiscard]] auto is_open() const noexcept -> bool { return m_file != nullptr; }
+    [[nodiscard]] auto records() const noexcept -> std::size_t { return m_records; }
+
+private:
+    std::FILE*  m_file    = nullptr;
+    std::size_t m_records = 0;
+};
+
+/**
+ * @brief Read only view of a trace file. The file is mapped, records are decoded in place
+ *        while iterating and nothing is copied up front.
+ */
+class trace_file {
+public:
+    explicit trace_file(std::string const& path);
+    ~trace_file();
+    trace_file(trace_file const&) = delete;
+    trace_file& operator=(trace_file const&) = delete;
+
+    // False when the file could not be read or has no trace header.
+    [[nodiscard]] auto is_open() const noexcept -> bool { return m_valid; }
+    [[nodiscard]] auto address() const noexcept -> uint32_t { return m_address; }
+    [[nodiscard]] auto size() const noexcept -> std::size_t { return m_size; }
+
+    class cursor {
+    public:
+        explicit cursor(trace_file const& file) noexcept;
+        // Decodes the next record, false at the end or at a record cut short.
+        auto next(trace_record& rec) noexcept -> bool;
+
+    private:
+        uint8_t const* m_data;
+        std::size_t    m_size;
+        std::size_t    m_offset;
+    };
+    [[nodiscard]] auto records() const noexcept -> cursor { return cursor{*this}; }
+
+private:
+    uint8_t const* m_data = nullptr;
+    std::size_t m_size    = 0;
+    bool        m_mapped  = false;
+    bool        m_valid   = false;
+    uint32_t    m_address = 0;
+    std::vector<uint8_t> m_copy{};  // Where mapping is not available
+};
+} // namespace ray
+
+#endif  // !SUNLIGHT_SIM_TRACE_FILE_HPP
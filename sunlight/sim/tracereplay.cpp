@@ -0,0 +1,72 @@
+/**
+ * @file   tracereplay.cpp
+ * @author Pratchaya Khansomboon (me@mononerv.dev)
+ * @brief  Replays a node trace into the host-built node logic and reports the throughput.
+ * @date   2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * tracereplay TRACE [--exit] [--repeat N]
+ *
+ * Traces come from a board built with -DSUNLIGHT_TRACE or from meshsim --record N@FILE.
+ */
+#include <cstdlib>
+#include <string>
+
+#include "fmt/format.h"
+#include "replay.hpp"
+#include "trace_file.hpp"
+
+auto main(int argc, char const* argv[]) -> int {
+    if (argc < 2) {
+        fmt::print(stderr, "usage: tracereplay TRACE [--exit] [--repeat N]\n");
+        return 1;
+    }
+    bool exit = false;
+    std::size_t repeat = 1;
+    for (int i = 2; i < argc; ++i) {
+        std::string const arg = argv[i];
+        if (arg == "--exit") {
+            exit = true;
+        } else if (arg == "--repeat" && i + 1 < argc) {
+            repeat = std::strtoull(argv[++i], nullptr, 10);
+        } else {
+            fmt::print(stderr, "usage: tracereplay TRACE [--exit] [--repeat N]\n");
+            return 1;
+        }
+    }
+
+    ray::trace_file const trace(argv[1]);
+    if (!trace.is_open()) {
+        fmt::print(stderr, "could not read a trace from {}\n", argv[1]);
+        return 1;
+    }
+
+    // Every pass starts from a fresh node so the passes do the same work
+    ray::replay_report report{};
+    double wall_seconds = 0.0;
+    uint64_t frames = 0;
+    ray::node_state state{};
+    std::size_t addresses = 0;
+    for (std::size_t pass = 0; pass < repeat; ++pass) {
+        ray::replayer replay(trace.address());
+        replay.set_exit(exit);
+        report = replay.run(trace);
+        wall_seconds += report.wall_seconds;
+        frames += report.frames;
+        state = replay.light().state();
+        addresses = replay.light().addresses().size();
+    }
+
+    fmt::print("node:             {:06X}\n", trace.address());
+    fmt::print("trace:            {} bytes, {} records over {:.1f} s\n", trace.size(), report.records,
+               static_cast<double>(report.last_ms) / 1000.0);
+    fmt::print("received:         {} packets\n", report.received);
+    fmt::print("sent:             {} recorded, {} replayed\n", report.sent_recorded, report.sent);
+    fmt::print("frames handled:   {}\n", report.frames);
+    fmt::print("addresses:        {}\n", addresses);
+    fmt::print("state:            {}\n", state == ray::node_state::fire ? "fire" : state == ray::node_state::idle ? "idle" : "config");
+    fmt::print("wall time:        {:.3f} s for {} passes\n", wall_seconds, repeat);
+    fmt::print("throughput:       {:.0f} frames/s\n", wall_seconds > 0.0 ? static_cast<double>(frames) / wall_seconds : 0.0);
+    return 0;
+}
@@ -8,16 +8,17 @@
  */
 #ifndef SUNLIGHT_CONFIG_STATUS_HPP
 #define SUNLIGHT_CONFIG_STATUS_HPP
+#include "hal.hpp"
 #include "control_register.hpp"
 
 namespace ray {
-class config_status {
+class config_status : public config_pins {
 public:
     config_status(uint8_t pin, control_register& control);
 
-    auto is_reset() const -> bool;
-    auto is_fire() const -> bool;
-    auto is_exit() const -> bool;
+    auto is_reset() const -> bool override;
+    auto is_fire() const -> bool override;
+    auto is_exit() const -> bool override;
 private:
     auto read_pin() const -> bool;
 
@@ -0,0 +1,84 @@
+/**
+ * @file   hal.hpp
+ * @author Pratchaya Khansomboon (me@mononerv.dev)
+ * @brief  Hardware the node logic talks to, implemented by the board or by a host simulation.
+ * @date   2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ */
+#ifndef SUNLIGHT_HAL_HPP
+#define SUNLIGHT_HAL_HPP
+#include <cstdint>
+#include <cstddef>
+
+namespace ray {
+constexpr std::size_t MAX_QUEUE   = 16;
+constexpr std::size_t MAX_CHANNEL = 4;
+
+struct packet {
+    uint8_t channel = 0;
+    uint8_t size    = 0;
+    uint8_t data[32]{};
+};
+
+// Milliseconds since start, wraps like Arduino millis().
+class clock {
+public:
+    virtual ~clock() = default;
+    virtual auto millis() const -> uint32_t = 0;
+};
+
+// Unique id of the chip, the low 24 bits are the node address.
+class chip {
+public:
+    virtual ~chip() = default;
+    virtual auto id() const -> uint32_t = 0;
+};
+
+// One serial link per channel, packets are raw bytes and frames are reassembled by the node.
+class channels {
+public:
+    virtual ~channels() = default;
+    virtual auto poll() -> void = 0;
+    virtual auto write(packet const& pkt) noexcept -> void = 0;
+    // Next received packet of the channel, size is 0 when there is none.
+    virtual auto read(uint8_t channel) noexcept -> packet = 0;
+    virtual auto clear_buffer(uint8_t channel) noexcept -> void = 0;
+    virtual auto overwritten(uint8_t channel) const noexcept -> std::size_t = 0;
+};
+
+// Addressable LEDs, one per channel. Colors are 0xRRGGBB.
+class leds {
+public:
+    virtual ~leds() = default;
+    virtual auto set_pixel(std::size_t index, uint32_t color) -> void = 0;
+    virtual auto show() -> void = 0;
+};
+
+// Switches selecting what the node is.
+class config_pins {
+public:
+    virtual ~config_pins() = default;
+    virtual auto is_reset() const -> bool = 0;
+    virtual auto is_fire() const -> bool = 0;
+    virtual auto is_exit() const -> bool = 0;
+};
+
+// Debug text output.
+class console {
+public:
+    virtual ~console() = default;
+    virtual auto print(char const* str) -> void = 0;
+};
+
+struct hal {
+    ray::clock&       time;
+    ray::chip&        chip_id;
+    ray::channels&    com;
+    ray::leds&        pixel;
+    ray::config_pins& config;
+    ray::console*     log = nullptr;  // Nothing is formatted without one
+};
+} // namespace ray
+
+#endif  // !SUNLIGHT_HAL_HPP
@@ -12,8 +12,45 @@
 namespace ray {
 multicom::multicom(int8_t rx_pin, int8_t tx_pin, uint32_t baud, control_register& control)
     : m_serial(rx_pin, tx_pin), m_baud(baud), m_control(control), m_in(), m_out() {
+    m_round_robin.seed(static_cast<uint32_t>(::random(1, INT32_MAX)));
+}
+auto multicom::set_scheduler(channel_scheduler* scheduler) noexcept -> void {
+    m_scheduler = scheduler != nullptr ? scheduler : &m_round_robin;
+}
+auto multicom::set_coalesce(bool coalesce) noexcept -> void {
+    for (auto& out : m_out) out.set_coalesce(coalesce);
+}
+auto multicom::set_priority(bool priority) noexcept -> void {
+    for (auto& out : m_out) out.set_priority(priority);
+}
+auto multicom::counters(uint8_t channel) const noexcept -> channel_counters {
+    if (channel >= MAX_CHANNEL) return {};
+    auto result = m_counters[channel];
+    result.suppressed = m_out[channel].suppressed();
+    result.evicted   = m_out[channel].evicted();
+    result.in_depth  = m_in[channel].size();
+    result.out_depth = m_out[channel].size();
+    return result;
+}
+auto multicom::read_packet() -> std::size_t {
+    auto const available = static_cast<std::size_t>(m_serial.available());
+    if (available == 0) return 0;
+    // Read straight into the queue slot, frames are reassembled from the byte stream by the receiver
+    auto& pkt = m_in[m_channel].emplace();
+    pkt.channel = m_channel;
+    pkt.size    = static_cast<uint8_t>(available < sizeof(pkt.data) ? available : sizeof(pkt.data));
+    m_serial.read(pkt.data, pkt.size);
+    ++m_counters[m_channel].packets_in;
+    m_counters[m_channel].bytes_in += pkt.size;
+    return pkt.size;
 }
 auto multicom::poll() -> void {
+    if (!m_started) {
+        auto const first = m_scheduler->first();
+        m_channel  = first.channel;
+        m_interval = first.interval_us;
+        m_started  = true;
+    }
     if (m_current == state::receive) {
         m_control.set_com_channel(m_channel, 0);
         m_serial.begin(m_baud);
@@ -22,53 +59,97 @@ auto multicom::poll() -> void {
     }
 
     if (m_current == state::wait) {
+        auto const now = micros();
         if (m_current != m_previous) {
-            m_start    = millis();
-            m_interval = random(16, 66);
-        } else if (millis() - m_start > m_interval) {
-            m_current = state::done;
+            m_start   = now;
+            m_seen    = 0;
+            m_drained = 0;
+        } else {
+            // In burst mode the serial buffer is emptied while listening so a burst fits
+            if (m_burst_us > 0 && static_cast<std::size_t>(m_serial.available()) >= sizeof(packet::data)) {
+                m_drained += read_packet();
+            }
+            auto const seen = m_drained + static_cast<std::size_t>(m_serial.available());
+            if (seen != m_seen) {
+                m_seen      = seen;
+                m_last_byte = now;
+            }
+            // A packet still coming in keeps the slot open, up to the scheduler's linger or a whole burst
+            auto const linger    = m_scheduler->linger_us() == 0 || m_scheduler->linger_us() > m_burst_us
+                                 ? m_scheduler->linger_us() : m_burst_us;
+            auto const byte_us   = 10u * 1000000u / m_baud;
+            auto const streaming = m_seen > 0 && now - m_last_byte < 2 * byte_us;
+            auto const elapsed   = now - m_start;
+            if (elapsed > m_interval && (!streaming || elapsed > m_interval + linger)) {
+                m_current = state::done;
+            }
         }
-    } 
+    }
 
     if (m_current == state::done) {
-        if (m_serial.available()) {
-            packet pkt{};
-            pkt.channel = m_channel;
-            pkt.size    = static_cast<uint8_t>(m_serial.available());
-            m_serial.read(pkt.data, pkt.size);
-            m_in[m_channel].enq(pkt);
+        auto& counters = m_counters[m_channel];
+        slot_outcome outcome{};
+        ++counters.slots;
+        if (m_drained > 0 || m_serial.available()) {
+            // One packet, the rest is dropped when the serial ends, unless draining a burst
+            do {
+                read_packet();
+            } while (m_burst_us > 0 && m_serial.available());
+            outcome.received = true;
         } else if (!m_out[m_channel].empty()) {
             // No data received, try to transmit data in current channel
-            auto const pack = m_out[m_channel].deq();
             m_serial.flush();
             m_serial.stopListening();
             m_control.set_com_channel(m_channel, 1);
-            m_serial.write(pack.data, pack.size);
+            // In burst mode keep sending while the next packet still fits in the burst time
+            auto const byte_us = 10u * 1000000u / m_baud;
+            uint32_t elapsed = 0;
+            do {
+                auto const& pack = m_out[m_channel].front();
+                m_serial.write(pack.data, pack.size);
+                elapsed += pack.size * byte_us;
+                ++counters.packets_out;
+                counters.bytes_out += pack.size;
+                m_out[m_channel].pop();
+            } while (m_burst_us > 0 && !m_out[m_channel].empty() &&
+                     elapsed + m_out[m_channel].front().size * byte_us <= m_burst_us);
             m_serial.flush();
+            outcome.sent = true;
         }
 
-        // Switch to next channel and wait for data
-        m_current = state::receive;
-        m_channel = (m_channel + 1) % MAX_CHANNEL;
+        // Switch to the channel the scheduler picks and wait for data
+        std::size_t pending[MAX_CHANNEL];
+        for (std::size_t i = 0; i < MAX_CHANNEL; ++i) pending[i] = m_out[i].size();
+        auto const next = m_scheduler->next(m_channel, outcome, pending);
+        m_current  = state::receive;
+        m_channel  = next.channel;
+        m_interval = next.interval_us;
         m_serial.end();
     }
 
     m_previous = m_current;
 }
 
-auto multicom::write(packet pkt) -> void {
+auto multicom::write(packet const& pkt) noexcept -> void {
     if (pkt.channel >= MAX_CHANNEL) return;
-    m_out[pkt.channel].enq(pkt);
+    if (m_recorder != nullptr) m_recorder->record({static_cast<uint32_t>(millis()), true, pkt});
+    m_out[pkt.channel].push(pkt);
 }
-auto multicom::read(uint8_t channel) -> packet {
+auto multicom::read(uint8_t channel) noexcept -> packet {
     if (channel >= MAX_CHANNEL) return {};
     if (m_in[channel].empty()) return {};
-    return m_in[channel].deq();
+    auto pkt = m_in[channel].deq();
+    if (m_recorder != nullptr) m_recorder->record({static_cast<uint32_t>(millis()), false, pkt});
+    return pkt;
 }
 auto multicom::clear_buffer(uint8_t channel) noexcept -> void{
     if (channel >= MAX_CHANNEL) return;
     m_out[channel].clear();
     m_in[channel].clear();
 }
+auto multicom::overwritten(uint8_t channel) const noexcept -> std::size_t {
+    if (channel >= MAX_CHANNEL) return 0;
+    return m_in[channel].overwritten() + m_out[channel].evicted();
+}
 
 } // namespace ray
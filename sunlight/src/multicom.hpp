@@ -12,34 +12,51 @@
 #include "SoftwareSerial.h"
 
 #include "sky.hpp"
+#include "hal.hpp"
+#include "trace.hpp"
+#include "out_queue.hpp"
+#include "scheduler.hpp"
 #include "control_register.hpp"
 
 namespace ray {
-constexpr std::size_t MAX_QUEUE   = 16;
-constexpr std::size_t MAX_CHANNEL = 4;
-
-struct packet {
-    uint8_t channel = 0;
-    uint8_t size    = 0;
-    uint8_t data[32]{};
-};
-
-class multicom {
+class multicom : public channels {
 public:
     multicom(int8_t rx_pin, int8_t tx_pin, uint32_t baud, control_register& control);
 
-    auto poll() -> void;
+    auto poll() -> void override;
 
-    auto write(packet pkt) noexcept -> void;
-    auto read(uint8_t channel) noexcept -> packet;
-    auto clear_buffer(uint8_t channel) noexcept -> void;
+    auto write(packet const& pkt) noexcept -> void override;
+    auto read(uint8_t channel) noexcept -> packet override;
+    auto clear_buffer(uint8_t channel) noexcept -> void override;
+    // Packets lost because the in or out queue of the channel was full.
+    auto overwritten(uint8_t channel) const noexcept -> std::size_t override;
+    // Every packet handed to write or returned by read goes to the recorder, nullptr stops it.
+    auto set_recorder(recorder* rec) noexcept -> void { m_recorder = rec; }
+    // Slot policy, round robin when not set. Takes effect on the next slot.
+    auto set_scheduler(channel_scheduler* scheduler) noexcept -> void;
+    [[nodiscard]] auto counters(uint8_t channel) const noexcept -> channel_counters;
+    // Longest back to back send in one slot, 0 sends one packet per slot. Both ends of a link
+    // need the same setting, the receiver drains the serial while listening to keep up.
+    auto set_burst(uint32_t burst_us) noexcept -> void { m_burst_us = burst_us; }
+    // Writes of a packet already queued on the channel add a copy to it instead of a place.
+    auto set_coalesce(bool coalesce) noexcept -> void;
+    // Fire and reset frames go out ahead of the routine traffic of the channel.
+    auto set_priority(bool priority) noexcept -> void;
+
+private:
+    // Reads what is available, at most one packet, into the in queue of the channel.
+    auto read_packet() -> std::size_t;
 
 private:
     SoftwareSerial m_serial;
     uint32_t m_baud;
     control_register& m_control;
+    recorder* m_recorder = nullptr;
+    round_robin_scheduler m_round_robin{};
+    channel_scheduler* m_scheduler = &m_round_robin;
+    channel_counters m_counters[MAX_CHANNEL]{};
     sky::queue<packet, MAX_QUEUE> m_in[MAX_CHANNEL];
-    sky::queue<packet, MAX_QUEUE> m_out[MAX_CHANNEL];
+    out_queue m_out[MAX_CHANNEL];
 
     enum class state {
         receive,
@@ -49,9 +66,14 @@ private:
     state m_current{state::receive};
     state m_previous{state::receive};
 
-    uint8_t  m_channel  = 0;
-    uint32_t m_start    = 0;
-    uint32_t m_interval = 0;
+    bool        m_started   = false;
+    uint8_t     m_channel   = 0;
+    uint32_t    m_start     = 0;  // micros()
+    uint32_t    m_interval  = 0;
+    uint32_t    m_burst_us  = 0;
+    std::size_t m_drained   = 0;  // Bytes read while listening
+    std::size_t m_seen      = 0;  // Bytes received in the slot at the last poll
+    uint32_t    m_last_byte = 0;  // micros() when that last changed
 };
 } // namespace ray
 
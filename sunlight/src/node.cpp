@@ -0,0 +1,817 @@
+/**
+ * @file   node.cpp
+ * @author Pratchaya Khansomboon (me@mononerv.dev)
+ * @author Linnéa Mörk
+ * @author Isac Pettersson
+ * @author Reem Mohamed
+ * @brief  Node logic of a sunlight light, independent of the board it runs on.
+ * @date   2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ */
+#include "node.hpp"
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+
+namespace ray {
+template <std::size_t N, typename Index>
+basic_node<N, Index>::basic_node(hal const& hw) : m_hw(hw) {
+    sky::mcp_u32_to_address(m_self, m_hw.chip_id.id());
+}
+
+template <std::size_t N, typename Index>
+auto basic_node<N, Index>::make_frame(uint8_t type, uint8_t seq) const -> sky::mcp {
+    sky::mcp mcp{ type, { 0, 0, 0 }, { 0, 0, 0 }, { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }, seq, 0 };
+    std::memcpy(mcp.source, m_self, sky::address_size);
+    return mcp;
+}
+
+template <std::size_t N, typename Index>
+auto basic_node<N, Index>::make_packet(sky::mcp const& frame, std::size_t channel) -> packet {
+    sky::mcp_buffer_t buffer{};
+    sky::mcp_make_buffer(buffer, frame);
+    return make_packet(sky::mcp_view{buffer}, channel);
+}
+
+template <std::size_t N, typename Index>
+auto basic_node<N, Index>::make_packet(sky::mcp_view const& frame, std::size_t channel) -> packet {
+    sky::mcp_wire_t wire{};
+    sky::mcp_make_wire(wire, frame.data());
+    packet pkt{};
+    std::memcpy(pkt.data, wire, sky::mcp_wire_size);
+    pkt.size    = static_cast<uint8_t>(sky::mcp_wire_size);
+    pkt.channel = static_cast<uint8_t>(channel);
+    return pkt;
+}
+
+template <std::size_t N, typename Index>
+auto basic_node<N, Index>::set_pixels(uint32_t color) -> void {
+    for (std::size_t i = 0; i < MAX_CHANNEL; i++) m_hw.pixel.set_pixel(i, color);
+}
+
+template <std::size_t N, typename Index>
+auto basic_node<N, Index>::print(char const* format, ...) -> void {
+    if (m_hw.log == nullptr) return;
+    char buffer[128];
+    va_list args;
+    va_start(args, format);
+    std::vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    m_hw.log->print(buffer);
+}
+
+template <std::size_t N, typename Index>
+auto basic_node<N, Index>::print_address(sky::address_t const& addr) -> void {
+    print("%02x:%02x:%02x", addr[0], addr[1], addr[2]);
+}
+
+template <std::size_t N, typename Index>
+auto basic_node<N, Index>::print_mcp(sky::mcp_view const& mcp) -> void {
+    if (m_hw.log == nullptr) return;
+    print_address(m_self);
+    print(": mcp{type: %02x, src: ", mcp.type());
+    print_address(mcp.source());
+    print(", dst: ");
+    print_address(mcp.destination());
+    print(", data: [");
+    for (std::size_t i = 0; i < sky::payload_size; ++i) {
+        print("%02x", mcp.payload()[i]);
+        if (i < sky::payload_size - 1) print(", ");
+    }
+    print("], seq: %d, crc: %d}\n", mcp.sequence(), mcp.crc());
+}
+
+template <std::size_t N, typename Index>
+auto basic_node<N, Index>::saveMyEdges() -> void {
+    //Save ONLY OUR edges. If my/neighbours exist in address_set just set them else add them first.
+    m_address_set.insert(m_self);
+    //Adds all edges to address_set if not exits
+    for (std::size_t i = 0; i < MAX_CHANNEL; ++i) {
+        if (m_verified_edges[i]) {
+            m_address_set.insert(m_edges[i]);
+        }
+    }
+
+    for (std::size_t i = 0; i < MAX_CHANNEL; ++i) {
+        if (!m_verified_edges[i]) continue;
+
+        //Find index of edge in address_set
+        auto const index = m_address_set.find(m_edges[i]);
+        if (index != m_address_set.npos) {
+            m_neighbour_list[0][i] = static_cast<int32_t>(index);
+        }
+    }
+    m_advert_dirty = true;
+}
+
+template <std::size_t N, typename Index>
+auto basic_node<N, Index>::updateEdges(sky::mcp_view const& mcp) -> void {
+    //address_set[0] addresser
+    //neighbour_list[0][0] grannar till address
+    auto const& payload = mcp.payload();
+    sky::address_t node_addr{ payload[0], payload[1], payload[2] };
+
+    sky::address_t neighbours[MAX_CHANNEL]{
+        { payload[3],  payload[4],  payload[5]  },
+        { payload[6],  payload[7],  payload[8]  },
+        { payload[9],  payload[10], payload[11] },
+        { payload[12], payload[13], payload[14] },
+    };
+
+    m_address_set.insert(node_addr);
+    for (std::size_t i = 0; i < MAX_CHANNEL; i++) {
+        m_address_set.insert(neighbours[i]);
+    }
+
+    //No room left for the node
+    auto const current_index = m_address_set.find(node_addr);
+    if (current_index == m_address_set.npos) return;
+
+    for (std::size_t i = 0; i < sky::length_of(neighbours); ++i) {
+        //Find index of edge in address_set, the 0 address is never found
+        auto const index = m_address_set.find(neighbours[i]);
+        if (index != m_address_set.npos) {
+            m_neighbour_list[current_index][i] = static_cast<int32_t>(index);
+        }
+    }
+
+    if (m_hw.log == nullptr) return;
+    print("current: ");
+    print_address(node_addr);
+    print(" - ");
+    for (std::size_t j = 0; j < MAX_CHANNEL; j++) {
+        print_address(neighbours[j]);
+        print(j < MAX_CHANNEL - 1 ? ", " : "\n");
+    }
+    print("exits\n");
+    for (std::size_t i = 0; i < m_exit_count; i++) {
+        print_address(m_exit_addrs[i]);
+        print("\n");
+    }
+    print("neighbour list\n");
+    for (std::size_t i = 0; i < m_address_set.size(); i++) {
+        print("%u: ", static_cast<unsigned>(i));
+        print_address(m_address_set[i]);
+        print(" - ");
+        for (std::size_t j = 0; j < MAX_CHANNEL; j++) {
+            auto const index = m_neighbour_list[i][j];
+            if (index == -1) {
+                print("-1: 00:00:00");
+            } else {
+                print("%d: ", index);
+                print_address(m_address_set[static_cast<std::size_t>(index)]);
+            }
+            print(j < MAX_CHANNEL - 1 ? ", " : "\n");
+        }
+    }
+}
+
+template <std::size_t N, typename Index>
+auto basic_node<N, Index>::createTopo() -> void {
+    //Lights not heard of yet have no links since setup, only the known part is rebuilt
+    auto const known = m_address_set.size();
+    for (std::size_t i = 0; i < known; i++) {
+        for (std::size_t j = 0; j < known; j++) {
+            m_topo.matrix[i][j] = i == j ? 0 : -1;
+        }
+    }
+
+    for (std::size_t i = 0; i < known; i++) {
+        for (std::size_t j = 0; j < MAX_CHANNEL; j++) {
+            if (m_neighbour_list[i][j] != -1) {
+                m_topo.matrix[i][m_neighbour_list[i][j]] = 1;
+            }
+        }
+    }
+}
+
+//Only the row of one node, the adverts change one node at a time
+template <std::size_t N, typename Index>
+auto basic_node<N, Index>::updateTopoRow(std::size_t row) -> void {
+    for (std::size_t j = 0; j < max_nodes; j++) {
+        m_topo.matrix[row][j] = row == j ? 0 : -1;
+    }
+    for (std::size_t j = 0; j < MAX_CHANNEL; j++) {
+        if (m_neighbour_list[row][j] != -1) {
+            m_topo.matrix[row][m_neighbour_list[row][j]] = 1;
+        }
+    }
+}
+
+template <std::size_t N, typename Index>
+auto basic_node<N, Index>::printTopo() -> void {
+    if (m_hw.log == nullptr) return;
+    for (std::size_t i = 0; i < max_nodes; i++) {
+        for (std::size_t j = 0; j < max_nodes; j++) {
+            //Show matrix
+            print("%c ", m_topo.matrix[i][j] > 0 ? '1' : m_topo.matrix[i][j] == -1 ? '-' : '0');
+        }
+        print("\n");
+    }
+}
+
+template <std::size_t N, typename Index>
+auto basic_node<N, Index>::printPath(path_t const& path) -> void {
+    if (m_hw.log == nullptr) return;
+    print("\nAnim Path: ");
+    for (std::size_t i = 0; i < max_nodes; i++) {
+        if (path[i] != 0) {
+            print("%d ", path[i] - 1);
+        }
+    }
+    print("\n");
+}
+
+//Remember a new exit, the tree has to be rebuilt with it
+template <std::size_t N, typename Index>
+auto basic_node<N, Index>::addExit(sky::address_t const& addr) -> void {
+    auto const begin = m_exit_addrs;
+    auto const end = m_exit_addrs + m_exit_count;
+    auto exist = std::find_if(begin, end, [&](sky::address_t const& exit) {
+        return sky::mcp_address_to_u32(exit) == sky::mcp_address_to_u32(addr);
+    });
+    if (exist != end || m_exit_count == max_exits) return;
+    std::memcpy(m_exit_addrs[m_exit_count++], addr, sky::address_size);
+    m_exit_tree_valid = false;
+}
+
+template <std::size_t N, typename Index>
+auto basic_node<N, Index>::savePath() -> void {
+    //Should happen in fire instead
+    uint32_t exit_index[max_exits]{};
+    std::size_t exits_known = 0;
+    for (std::size_t i = 0; i < m_exit_count; i++) {
+        auto const index = m_address_set.find(m_exit_addrs[i]);
+        if (index != m_address_set.npos) exit_index[exits_known++] = static_cast<uint32_t>(index);
+    }
+
+    if (exits_known > 0) {
+        //One run from all exits gives every node its nearest way out, fire only repairs it
+        if (!m_exit_tree_valid || m_exit_tree.exit_count() != exits_known) {
+            sky::sparse_topo_from_dense(m_sparse_topology, m_topo);
+            m_exit_tree.build(m_sparse_topology, exit_index, exits_known);
+            m_exit_tree_valid = true;
+            m_path_changed = true;
+        }
+        //Nothing moved since last time, keep the animation as is
+        if (!m_path_changed) return;
+        m_path_changed = false;
+
+        //The longest way out is the animation path, only its length is needed of the others
+        uint32_t path[max_nodes]{};
+        std::size_t maxIndex = 0;
+        std::size_t maxLength = 0;
+        if (m_hw.log != nullptr) print("Paths in list\n");
+        for (std::size_t i = 0; i < m_address_set.size(); i++) {
+            auto const length = m_exit_tree.path(static_cast<uint32_t>(i), path, max_nodes);
+            if (length > maxLength) {
+                maxLength = length;
+                maxIndex = i;
+            }
+            if (m_hw.log != nullptr && i < 5) {
+                path_t logged{};
+                for (std::size_t j = 0; j < length; j++) logged[j] = static_cast<Index>(path[j] + 1);
+                printPath(logged);
+            }
+        }
+        //From maxIndex to exit, + 1 because thats how the path is stored
+        std::memset(m_shortestpath, 0, sizeof(path_t));
+        auto const length = m_exit_tree.path(static_cast<uint32_t>(maxIndex), path, max_nodes);
+        for (std::size_t j = 0; j < length; j++) {
+            m_shortestpath[j] = static_cast<Index>(path[j] + 1);
+        }
+    }
+}
+
+template <std::size_t N, typename Index>
+auto basic_node<N, Index>::make_advert_packet(sky::link_state_advert const& advert, sky::address_t const& destination, std::size_t channel) -> packet {
+    // The origin is the source, so the advert looks the same whoever passes it on
+    sky::mcp mcp{ 6, { 0, 0, 0 }, { 0, 0, 0 }, { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }, static_cast<uint8_t>(advert.version), 0 };
+    std::memcpy(mcp.source, advert.origin, sky::address_size);
+    std::memcpy(mcp.destination, destination, sky::address_size);
+    sky::link_state_encode_advert(mcp.payload, advert);
+    return make_packet(mcp, channel);
+}
+
+//Store an advert newer than what is known and pass it on, channel is MAX_CHANNEL for my own
+template <std::size_t N, typename Index>
+auto basic_node<N, Index>::apply_advert(sky::link_state_advert const& advert, std::size_t channel) -> void {
+    auto const origin = sky::mcp_address_to_u32(advert.origin);
+    if (channel < MAX_CHANNEL && origin == sky::mcp_address_to_u32(m_self)) {
+        //Someone holds a later version of me than I sent, from before a restart. Go past it.
+        if (sky::link_state_newer(advert.version, m_advert_version)) {
+            m_advert_version = advert.version;
+            m_advert_dirty = true;
+        }
+        return;
+    }
+    //Known already, or no room left, which also means no room for it in the topology
+    if (m_link_states.apply(advert) == m_link_states.npos) return;
+
+    if ((advert.flags & sky::link_state_exit) != 0) addExit(advert.origin);
+    m_address_set.insert(advert.origin);
+    for (std::size_t i = 0; i < MAX_CHANNEL; i++) {
+        m_address_set.insert(advert.links[i]);
+    }
+    auto const row = m_address_set.find(advert.origin);
+    if (row != m_address_set.npos) {
+        for (std::size_t i = 0; i < MAX_CHANNEL; i++) {
+            auto const index = m_address_set.find(advert.links[i]);
+            m_neighbour_list[row][i] = index == m_address_set.npos ? -1 : static_cast<int32_t>(index);
+        }
+        updateTopoRow(row);
+        m_exit_tree_valid = false;
+    }
+
+    for (std::size_t i = 0; i < MAX_CHANNEL; i++) {
+        if (channel != i && m_verified_edges[i] == true) {
+            auto const out = make_advert_packet(advert, m_edges[i], i);
+            for (std::size_t j = 0; j < gossip_copies; ++j) m_hw.com.write(out);
+        }
+    }
+}
+
+template <std::size_t N, typename Index>
+auto basic_node<N, Index>::send_advert() -> void {
+    m_advert_dirty = false;
+    sky::link_state_advert advert{};
+    std::memcpy(advert.origin, m_self, sky::address_size);
+    if (m_hw.config.is_exit()) advert.flags |= sky::link_state_exit;
+    for (std::size_t i = 0; i < MAX_CHANNEL; i++) {
+        if (m_verified_edges[i]) std::memcpy(advert.links[i], m_edges[i], sky::address_size);
+    }
+    //Nothing changed since the last one
+    auto const last = m_link_states.find(m_self);
+    if (last != nullptr && last->version == m_advert_version && last->flags == advert.flags
+        && std::memcmp(last->links, advert.links, sizeof(advert.links)) == 0) return;
+
+    if (++m_advert_version == 0) m_advert_version = 1;
+    advert.version = m_advert_version;
+    apply_advert(advert, MAX_CHANNEL);
+}
+
+//Only when my edges changed, the digests catch up what got lost
+template <std::size_t N, typename Index>
+auto basic_node<N, Index>::gossip(uint32_t now) -> void {
+    if (m_advert_dirty) send_advert();
+    if (now - m_digest_time > digest_interval) {
+        m_digest_time = now;
+        send_digest();
+    }
+}
+
+template <std::size_t N, typename Index>
+auto basic_node<N, Index>::send_digest() -> void {
+    sky::link_state_digest entries[sky::link_state_digests]{};
+    auto const count = m_link_states.next_digest(entries, sky::link_state_digests);
+    if (count == 0) return;
+
+    auto digest = make_frame(7, m_sequence++);
+    sky::link_state_encode_digest(digest.payload, entries, count);
+    for (std::size_t i = 0; i < MAX_CHANNEL; i++) {
+        if (m_verified_edges[i] == true) {
+            std::memcpy(digest.destination, m_edges[i], sky::address_size);
+            auto const out = make_packet(digest, i);
+            for (std::size_t j = 0; j < gossip_copies; ++j) m_hw.com.write(out);
+        }
+    }
+}
+
+//Send back what the neighbour is behind on, ask for what I am behind on
+template <std::size_t N, typename Index>
+auto basic_node<N, Index>::handle_digest(sky::mcp_view const& mcp, std::size_t channel) -> void {
+    sky::link_state_digest entries[sky::link_state_digests]{};
+    auto const count = sky::link_state_decode_digest(mcp.payload(), entries);
+
+    sky::link_state_digest behind[sky::link_state_digests]{};
+    std::size_t behind_count = 0;
+    for (std::size_t i = 0; i < count; i++) {
+        auto const& entry = entries[i];
+        if (sky::mcp_address_to_u32(entry.origin) == sky::mcp_address_to_u32(m_self)
+            && sky::link_state_newer(entry.version, m_advert_version)) {
+            m_advert_version = entry.version;
+            m_advert_dirty = true;
+            continue;
+        }
+        auto const known = m_link_states.find(entry.origin);
+        if (known != nullptr && sky::link_state_newer(known->version, entry.version)) {
+            auto const out = make_advert_packet(*known, mcp.source(), channel);
+            for (std::size_t j = 0; j < gossip_copies; ++j) m_hw.com.write(out);
+        } else if (known == nullptr ? entry.version != 0 : sky::link_state_newer(entry.version, known->version)) {
+            //Neither knowing it is not worth a reply, the two would ask each other forever
+            std::memcpy(behind[behind_count].origin, entry.origin, sky::address_size);
+            behind[behind_count++].version = known == nullptr ? 0 : known->version;
+        }
+    }
+    if (behind_count == 0) return;
+
+    auto reply = make_frame(7, m_sequence++);
+    std::memcpy(reply.destination, mcp.source(), sky::address_size);
+    sky::link_state_encode_digest(reply.payload, behind, behind_count);
+    auto const out = make_packet(reply, channel);
+    for (std::size_t j = 0; j < gossip_copies; ++j) m_hw.com.write(out);
+}
+
+template <std::size_t N, typename Index>
+auto basic_node<N, Index>::setup() -> void {
+    print("\n");
+    m_address_set.clear();
+    m_address_set.insert(m_self);
+    //Version 1 is me without edges, so there is always room for me in the table
+    sky::link_state_advert advert{};
+    std::memcpy(advert.origin, m_self, sky::address_size);
+    advert.version = m_advert_version = 1;
+    m_link_states.clear();
+    m_link_states.apply(advert);
+    //Any type past the ones in use is taken for noise
+    for (auto& deframer : m_deframers) deframer = sky::mcp_deframer{static_cast<uint8_t>(m_link_state ? 8 : 6)};
+
+    for (std::size_t i = 0; i < max_nodes; i++) {
+        for (std::size_t j = 0; j < MAX_CHANNEL; j++) {
+            m_neighbour_list[i][j] = -1;
+        }
+        for (std::size_t j = 0; j < max_nodes; j++) {
+            m_topo.matrix[i][j] = i == j ? 0 : -1;
+        }
+    }
+}
+
+template <std::size_t N, typename Index>
+auto basic_node<N, Index>::handle_message(packet const& pkt) -> void {
+    if (pkt.size != sky::mcp_buffer_size) return;
+
+    // Read the frame in place, forwarding patches a copy of the frame directly
+    sky::mcp_view const mcp{pkt.data};
+    if (!mcp.check_crc()) return;
+    // Discovery and acks are link local, everything else is flooded and checked for copies.
+    // Adverts carry a version that does the same and digests are link local.
+    auto const is_ack = (mcp.type() == 3 || mcp.type() == 4) && mcp.payload()[0] == 1;
+    auto const is_gossip = mcp.type() == 6 || mcp.type() == 7;
+    if (mcp.type() != 0 && !is_ack && !is_gossip && m_seen_frames.is_duplicate(mcp)) return;
+
+    auto const channel = pkt.channel;
+
+    //If type 0 edges finding
+    if (mcp.type() == 0) {
+        //If ack just verify the edge and save its mac
+        if (mcp.payload()[0] == 1) {
+            std::memcpy(m_edges[channel], mcp.source(), sky::address_size);
+            m_verified_edges[channel] = true;
+            saveMyEdges();
+        } else if (mcp.payload()[0] == 0) {
+            //If recived from channel not verified just save its MAC
+            if (m_verified_edges[channel] == false && m_state == node_state::idle) {
+                std::memcpy(m_edges[channel], mcp.source(), sky::address_size);
+                m_verified_edges[channel] = true;
+                saveMyEdges();
+            }
+            //Replying with ACK (payload[0] == 1)
+            auto ack = make_frame(0, 0);
+            ack.payload[0] = 1;
+            std::memcpy(ack.destination, mcp.source(), sky::address_size);
+            auto const reply = make_packet(ack, channel);
+            for (std::size_t i = 0; i < 16; i++) {
+                m_hw.com.write(reply);
+            }
+        }
+        //Topology
+    } else if (mcp.type() == 1) {
+        updateEdges(mcp);
+        createTopo();
+        m_exit_tree_valid = false;
+        printTopo();
+
+        for (std::size_t i = 0; i < MAX_CHANNEL; i++) {
+            if (channel != i && m_verified_edges[i] == true) {
+                sky::mcp_buffer_t forward{};
+                std::memcpy(forward, pkt.data, sky::mcp_buffer_size);
+                sky::mcp_mut_view{forward}.set_destination(m_edges[i]);
+                if (m_hw.log != nullptr) {
+                    print("Sent on CH: %02x ", static_cast<unsigned>(i));
+                    print_mcp(sky::mcp_view{forward});
+                    print("\n");
+                }
+                auto const out = make_packet(sky::mcp_view{forward}, i);
+                for (std::size_t j = 0; j < 16; ++j) m_hw.com.write(out);
+            }
+        }
+        //Animation
+    } else if (mcp.type() == 2) {
+        //What should happen when reciving animation packet (light up 3-2 sek IDK and turn off wait 1 sek repeat)
+        if (!m_hw.config.is_exit()) {
+            auto const address_index = m_address_set.find(mcp.source());
+
+            if (address_index != m_address_set.npos) {
+                sky::address_t next_address{};
+                for (std::size_t i = 0; i + 2 < max_nodes; ++i) {
+                    if (m_shortestpath[i] == address_index) {
+                        std::memcpy(next_address, m_address_set[i + 2], sky::address_size);
+                        break;
+                    }
+                }
+
+                auto const next_channel_it = std::find_if(m_edges, m_edges + sky::length_of(m_edges), [&next_address](auto const& addr) {
+                    return sky::mcp_address_to_u32(addr) == sky::mcp_address_to_u32(next_address);
+                });
+                auto const next_index = static_cast<std::size_t>(std::distance(m_edges, next_channel_it));
+
+                auto animation = make_frame(2, m_sequence++);
+                std::memcpy(animation.destination, next_address, sky::address_size);
+                auto const out = make_packet(animation, next_index);
+                for (std::size_t i = 0; i < 8; i++) {
+                    m_hw.com.write(out);
+                }
+            }
+        }
+
+        m_has_animation_packet = true;
+
+        //FIRE
+    } else if (mcp.type() == 3) {
+        if (mcp.payload()[0] == 1) {
+            m_neighbour_in_fire[channel] = true;
+            m_hw.com.clear_buffer(channel);
+        } else {
+            if (m_state != node_state::fire) std::memcpy(m_fire_source, mcp.source(), sky::address_size);
+            m_state = node_state::fire;
+
+            if (m_hw.log != nullptr) {
+                print("\nAddress on fire: ");
+                print_address(mcp.source());
+                print("\n");
+            }
+            //See if node thats on fire exists in address_set
+            auto const index = m_address_set.find(mcp.source());
+
+            //If it exists its on fire and needs to be set into firemode (removed)
+            if (index != m_address_set.npos) {
+                sky::topo_set_node_firemode(m_topo, static_cast<uint32_t>(index));
+                if (m_exit_tree_valid) {
+                    //Only lights whose next hop moved need a new path
+                    m_exit_tree.set_node_firemode(m_sparse_topology, static_cast<uint32_t>(index));
+                    if (m_exit_tree.changed_count() > 0) m_path_changed = true;
+                }
+            }
+
+            for (std::size_t i = 0; i < MAX_CHANNEL; i++) {
+                if (m_verified_edges[i] == true) {
+                    // Acknowledge back to the sender, forward to everyone else
+                    sky::mcp_buffer_t forward{};
+                    std::memcpy(forward, pkt.data, sky::mcp_buffer_size);
+                    sky::mcp_mut_view patch{forward};
+                    patch.set_payload(0, channel == i ? 1 : 0);
+                    patch.set_destination(m_edges[i]);
+                    auto const out = make_packet(sky::mcp_view{forward}, i);
+
+                    for (std::size_t j = 0; j < 16; ++j) { // Flood the buffer
+                        m_hw.com.write(out);
+                    }
+                }
+            }
+        }
+        //RESET
+    } else if (mcp.type() == 4) {
+        if (mcp.payload()[0] == 1) {
+            m_neighbour_in_fire[channel] = false;
+            m_hw.com.clear_buffer(channel);
+        } else {
+            m_state = node_state::idle;
+
+            for (std::size_t i = 0; i < MAX_CHANNEL; i++) {
+                if (m_verified_edges[i] == true) {
+                    // Acknowledge back to the sender, forward to everyone else. The source and
+                    // sequence stay those of the first reset, so the copies die out in dedup
+                    sky::mcp_buffer_t forward{};
+                    std::memcpy(forward, pkt.data, sky::mcp_buffer_size);
+                    sky::mcp_mut_view patch{forward};
+                    patch.set_payload(0, channel == i ? 1 : 0);
+                    patch.set_destination(m_edges[i]);
+                    auto const out = make_packet(sky::mcp_view{forward}, i);
+
+                    for (std::size_t j = 0; j < 16; ++j) { // Flood the buffer
+                        m_hw.com.write(out);
+                    }
+                }
+            }
+        }
+        //Exit broadcast
+    } else if (mcp.type() == 5) {
+        addExit(mcp.source());
+        for (std::size_t i = 0; i < MAX_CHANNEL; i++) {
+            if (m_verified_edges[i] == true && channel != i) {
+                sky::mcp_buffer_t forward{};
+                std::memcpy(forward, pkt.data, sky::mcp_buffer_size);
+                sky::mcp_mut_view{forward}.set_destination(m_edges[i]);
+                auto const out = make_packet(sky::mcp_view{forward}, i);
+                for (std::size_t j = 0; j < 16; j++) {
+                    m_hw.com.write(out);
+                }
+            }
+        }
+        //Link-state advert
+    } else if (mcp.type() == 6) {
+        if (m_link_state) apply_advert(sky::link_state_decode_advert(mcp.source(), mcp.payload()), channel);
+        //Link-state digest
+    } else if (mcp.type() == 7) {
+        if (m_link_state) handle_digest(mcp, channel);
+    }
+}
+
+template <std::size_t N, typename Index>
+auto basic_node<N, Index>::receive_packet(packet const& pkt) -> void {
+    if (pkt.size == 0 || pkt.channel >= MAX_CHANNEL) return;
+    m_deframers[pkt.channel].push(pkt.data, pkt.size, [this, &pkt](sky::mcp_view const& frame) {
+        ++m_frames_received;
+        packet whole{};
+        whole.channel = pkt.channel;
+        whole.size    = static_cast<uint8_t>(sky::mcp_buffer_size);
+        std::memcpy(whole.data, frame.data(), sky::mcp_buffer_size);
+        handle_message(whole);
+    });
+}
+
+template <std::size_t N, typename Index>
+auto basic_node<N, Index>::receive_all() -> void {
+    for (std::size_t i = 0; i < MAX_CHANNEL; ++i) {
+        auto const pkt = m_hw.com.read(static_cast<uint8_t>(i));
+        receive_packet(pkt);
+        if (m_state == node_state::config && m_hw.log != nullptr && pkt.size == sky::mcp_wire_size) {
+            print_mcp(sky::mcp_view{pkt.data});
+        }
+    }
+}
+
+template <std::size_t N, typename Index>
+auto basic_node<N, Index>::loop_config() -> void {
+    set_pixels(0xFFFF00);
+
+    auto const now = m_hw.time.millis();
+    if (now - m_start_time > 125) {
+        m_start_time = now;
+        --m_max_config_tries;
+
+        auto const discover = make_frame(0, 0);
+        for (std::size_t i = 0; i < MAX_CHANNEL; ++i) {
+            if (!m_verified_edges[i]) m_hw.com.write(make_packet(discover, i));
+        }
+
+        if (m_link_state) {
+            //Exits go out with the adverts
+            if (m_hw.config.is_exit()) addExit(m_self);
+            gossip(now);
+        } else if (m_hw.config.is_exit()) {
+            addExit(m_self);
+            auto exit = make_frame(5, m_sequence++);
+            for (std::size_t i = 0; i < MAX_CHANNEL; i++) {
+                if (m_verified_edges[i]) {
+                    std::memcpy(exit.destination, m_edges[i], sky::address_size);
+                    auto const out = make_packet(exit, i);
+                    for (std::size_t j = 0; j < 16; j++) {
+                        m_hw.com.write(out);
+                    }
+                }
+            }
+        }
+    }
+
+    receive_all();
+
+    if (m_max_config_tries == 0) {
+        if (m_hw.log != nullptr) {
+            int32_t edge_count = 0;
+            for (std::size_t i = 0; i < MAX_CHANNEL; ++i)
+                if (m_verified_edges[i]) ++edge_count;
+
+            print("\n\nconnected edges: %d, [", edge_count);
+            for (std::size_t i = 0; i < MAX_CHANNEL; ++i) {
+                print_address(m_edges[i]);
+                print(i < MAX_CHANNEL - 1 ? ", " : "]\n\n");
+            }
+        }
+        m_start_time = 0;
+        m_state = node_state::idle;
+    }
+}
+
+template <std::size_t N, typename Index>
+auto basic_node<N, Index>::loop_idle() -> void {
+    //Show neighbours
+    for (std::size_t i = 0; i < MAX_CHANNEL; i++) {
+        m_hw.pixel.set_pixel(i, m_verified_edges[i] ? 0x00FF00 : 0x000000);
+    }
+
+    auto const now = m_hw.time.millis();
+    if (now - m_start_time > 125) {
+        m_start_time = now;
+
+        if (m_link_state) gossip(now);
+
+        auto const topo_sequence = m_sequence++;
+        for (std::size_t i = 0; i < MAX_CHANNEL && !m_link_state; i++) {
+            if (sky::mcp_address_to_u32(m_edges[i]) != 0 && m_verified_edges[i] == true) {
+                auto mcp = make_frame(1, topo_sequence);
+                std::memcpy(mcp.destination, m_edges[i], sky::address_size);
+                std::memcpy(mcp.payload, mcp.source, sky::address_size);
+                for (std::size_t j = 0; j < MAX_CHANNEL; j++) {
+                    std::memcpy(mcp.payload + 3 + j * sky::address_size, m_edges[j], sky::address_size);
+                }
+                m_hw.com.write(make_packet(mcp, i));
+            }
+        }
+
+        auto const reset_sequence = m_sequence++;
+        for (std::size_t i = 0; i < MAX_CHANNEL; i++) {
+            if (m_neighbour_in_fire[i] == true && m_verified_edges[i] == true) {
+                m_hw.com.write(make_packet(make_frame(4, reset_sequence), i));
+            }
+        }
+    }
+
+    receive_all();
+
+    if (m_hw.config.is_fire()) {
+        if (m_state != node_state::fire) std::memcpy(m_fire_source, m_self, sky::address_size);
+        m_state = node_state::fire;
+        m_fire_node = true;
+        // Every repeat of the fire frame is the same frame to the rest of the mesh
+        m_fire_sequence = m_sequence++;
+        savePath();
+        set_pixels(0xFF0000);
+    }
+}
+
+template <std::size_t N, typename Index>
+auto basic_node<N, Index>::loop_fire() -> void {
+    if (m_fire_node) {
+        auto const fire = make_frame(3, m_fire_sequence);
+        for (std::size_t i = 0; i < MAX_CHANNEL; i++) {
+            if (m_neighbour_in_fire[i] == false && m_verified_edges[i] == true) {
+                m_hw.com.write(make_packet(fire, i));
+            }
+        }
+    }
+
+    auto const now = m_hw.time.millis();
+    if (now - m_start_time > 2000) {
+        m_start_time = now;
+
+        //Check if first index in shortestPath is mine. 0 in address_set is always me.
+        if (m_shortestpath[0] == 0) {
+            set_pixels(m_is_light_on ? 0x0011ff : 0x000000);
+            m_is_light_on = !m_is_light_on;
+
+            sky::address_t next_address;
+            std::memcpy(next_address, m_address_set[m_shortestpath[1]], sky::address_size);
+
+            auto const next_channel_it = std::find_if(m_edges, m_edges + sky::length_of(m_edges), [&next_address](auto const& addr) {
+                return sky::mcp_address_to_u32(addr) == sky::mcp_address_to_u32(next_address);
+            });
+            auto const next_index = static_cast<std::size_t>(std::distance(m_edges, next_channel_it));
+            m_hw.com.write(make_packet(make_frame(2, m_sequence++), next_index));
+        } else if (m_has_animation_packet) {
+            set_pixels(m_is_light_on ? 0x0011ff : 0x000000);
+            m_is_light_on = !m_is_light_on;
+        }
+
+        printTopo();
+        printPath(m_shortestpath);
+        savePath();
+        if (m_hw.log != nullptr) {
+            print("frames: %u handled, %u duplicates dropped\n", m_seen_frames.stats().accepted, m_seen_frames.stats().duplicates);
+            print("overwritten: %u, %u, %u, %u\n",
+                  static_cast<unsigned>(m_hw.com.overwritten(0)), static_cast<unsigned>(m_hw.com.overwritten(1)),
+                  static_cast<unsigned>(m_hw.com.overwritten(2)), static_cast<unsigned>(m_hw.com.overwritten(3)));
+        }
+    }
+
+    if (m_hw.config.is_reset()) {
+        m_state = node_state::idle;
+    }
+
+    receive_all();
+}
+
+template <std::size_t N, typename Index>
+auto basic_node<N, Index>::loop() -> void {
+    m_hw.com.poll();
+
+    switch (m_state) {
+    case node_state::config: loop_config(); break;
+    case node_state::idle:   loop_idle();   break;
+    case node_state::fire:   loop_fire();   break;
+    }
+
+    auto const now = m_hw.time.millis();
+    if (now - m_pixel_time > m_pixel_interval) {
+        m_pixel_time = now;
+        m_hw.pixel.show();
+    }
+}
+
+template class basic_node<16, uint8_t>;
+#ifndef ARDUINO
+template class basic_node<256, uint16_t>;
+#endif
+} // namespace ray
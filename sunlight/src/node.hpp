@@ -0,0 +1,180 @@
+/**
+ * @file   node.hpp
+ * @author Pratchaya Khansomboon (me@mononerv.dev)
+ * @author Linnéa Mörk
+ * @author Isac Pettersson
+ * @author Reem Mohamed
+ * @brief  Node logic of a sunlight light, independent of the board it runs on.
+ * @date   2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ */
+#ifndef SUNLIGHT_NODE_HPP
+#define SUNLIGHT_NODE_HPP
+#include <cstdint>
+#include <cstddef>
+
+#include "sky.hpp"
+#include "hal.hpp"
+
+namespace ray {
+enum class node_state {
+    config,
+    idle,
+    fire
+};
+
+/**
+ * @brief One light in the mesh: edge discovery, topology flooding, routing to the nearest
+ *        exit and the fire/reset animation. Everything outside the node goes through hal,
+ *        so the same logic runs on the board and many times over in one host process.
+ *
+ *        N is the number of lights a node can know of and Index the type of their ids in
+ *        the paths, Index has to hold N. The topology is a dense N x N matrix, so memory
+ *        grows with N^2. See node and host_node.
+ */
+template <std::size_t N, typename Index>
+class basic_node {
+public:
+    static constexpr std::size_t max_nodes = N;
+    static constexpr std::size_t max_exits = 4;
+    using topo_t = sky::basic_topo<max_nodes, Index>;
+    using path_t = typename topo_t::path_t;
+    // Writes of an advert or digest per channel, one write is lost about half the time
+    static constexpr std::size_t gossip_copies   = 4;
+    static constexpr uint32_t    digest_interval = 2000;
+
+public:
+    explicit basic_node(hal const& hw);
+
+    // Gossip topology and exits as versioned adverts and digests instead of flooding them
+    // every tick. Every node of a mesh has to use the same, set it before setup.
+    auto set_link_state(bool link_state) noexcept -> void { m_link_state = link_state; }
+    [[nodiscard]] auto link_state() const noexcept -> bool { return m_link_state; }
+
+    auto setup() -> void;
+    // One pass of the state machine, call as often as possible.
+    auto loop() -> void;
+
+    // Raw bytes from a channel, complete frames are handled as they come in.
+    auto receive_packet(packet const& pkt) -> void;
+    auto handle_message(packet const& pkt) -> void;
+
+    [[nodiscard]] auto state() const noexcept -> node_state { return m_state; }
+    [[nodiscard]] auto address() const noexcept -> sky::address_t const& { return m_self; }
+    [[nodiscard]] auto edge(std::size_t channel) const noexcept -> sky::address_t const& { return m_edges[channel]; }
+    [[nodiscard]] auto is_edge_verified(std::size_t channel) const noexcept -> bool { return m_verified_edges[channel]; }
+    [[nodiscard]] auto addresses() const noexcept -> sky::address_map<max_nodes> const& { return m_address_set; }
+    [[nodiscard]] auto topology() const noexcept -> topo_t const& { return m_topo; }
+    [[nodiscard]] auto exit_count() const noexcept -> std::size_t { return m_exit_count; }
+    [[nodiscard]] auto shortest_path() const noexcept -> path_t const& { return m_shortestpath; }
+    // Source of the fire frame that put the node into fire mode, its own address for its switch.
+    [[nodiscard]] auto fire_source() const noexcept -> sky::address_t const& { return m_fire_source; }
+    [[nodiscard]] auto frame_stats() const noexcept -> sky::mcp_dedup_stats const& { return m_seen_frames.stats(); }
+    [[nodiscard]] auto link_state_stats() const noexcept -> sky::link_state_stats const& { return m_link_states.stats(); }
+    // Whole frames out of the deframers, duplicates included.
+    [[nodiscard]] auto frames_received() const noexcept -> uint32_t { return m_frames_received; }
+
+private:
+    auto saveMyEdges() -> void;
+    auto updateEdges(sky::mcp_view const& mcp) -> void;
+    auto createTopo() -> void;
+    auto addExit(sky::address_t const& addr) -> void;
+    auto savePath() -> void;
+    auto updateTopoRow(std::size_t row) -> void;
+
+    auto gossip(uint32_t now) -> void;
+    auto send_advert() -> void;
+    auto send_digest() -> void;
+    auto apply_advert(sky::link_state_advert const& advert, std::size_t channel) -> void;
+    auto handle_digest(sky::mcp_view const& mcp, std::size_t channel) -> void;
+    static auto make_advert_packet(sky::link_state_advert const& advert, sky::address_t const& destination, std::size_t channel) -> packet;
+
+    auto loop_config() -> void;
+    auto loop_idle() -> void;
+    auto loop_fire() -> void;
+    auto receive_all() -> void;
+    auto set_pixels(uint32_t color) -> void;
+
+    // Frame with this node as source, the destination is left at 0.
+    auto make_frame(uint8_t type, uint8_t seq) const -> sky::mcp;
+    static auto make_packet(sky::mcp const& frame, std::size_t channel) -> packet;
+    // Packet with the frame as it goes on the wire, see sky::mcp_make_wire.
+    static auto make_packet(sky::mcp_view const& frame, std::size_t channel) -> packet;
+
+    auto print(char const* format, ...) -> void;
+    auto print_mcp(sky::mcp_view const& mcp) -> void;
+    auto print_address(sky::address_t const& addr) -> void;
+    auto printTopo() -> void;
+    auto printPath(path_t const& path) -> void;
+
+private:
+    hal m_hw;
+    sky::address_t m_self{};
+
+    node_state m_state = node_state::config;
+    int32_t m_max_config_tries = 255;
+
+    sky::address_t m_edges[MAX_CHANNEL]{};
+    bool m_verified_edges[MAX_CHANNEL]{false, false, false, false};
+    //Needs to be improved
+    bool m_neighbour_in_fire[MAX_CHANNEL]{false, false, false, false};
+
+    //Every exit heard of, each node is routed to the nearest one
+    sky::address_t m_exit_addrs[max_exits]{};
+    std::size_t m_exit_count = 0;
+
+    uint32_t m_start_time = 0;
+
+    //Index of an address is its node in the topology, 0 is always me
+    sky::address_map<max_nodes> m_address_set{};
+    int32_t m_neighbour_list[max_nodes][MAX_CHANNEL]{};
+    topo_t m_topo{};
+    // Way out for every node, repaired when a node goes into firemode instead of recomputed
+    sky::sparse_topo<max_nodes, max_nodes * MAX_CHANNEL> m_sparse_topology{};
+    sky::exit_tree<max_nodes, max_nodes * MAX_CHANNEL> m_exit_tree{};
+    bool m_exit_tree_valid = false;
+    bool m_path_changed = true;
+
+    bool m_fire_node = false;
+    sky::address_t m_fire_source{};
+
+    // Sequence for frames this node originates, flooded copies and forwards keep theirs
+    uint8_t m_sequence = 0;
+    uint8_t m_fire_sequence = 0;
+    // Drops flooded copies of a frame before they are handled
+    sky::mcp_dedup_cache<> m_seen_frames{};
+
+    //Chosen path
+    path_t m_shortestpath{};
+
+    uint32_t m_pixel_time     = 0;
+    uint32_t m_pixel_interval = 33;
+
+    bool m_is_light_on = false;
+    bool m_has_animation_packet = false;
+
+    // Link-state gossip, my own advert is in the table as well
+    bool m_link_state = false;
+    bool m_advert_dirty = false;
+    uint16_t m_advert_version = 0;
+    uint32_t m_digest_time = 0;
+    sky::link_state_table<max_nodes> m_link_states{};
+
+    // Reassemble frames from the raw bytes of every channel, types 0-5 are in use, 6 and 7 with link-state
+    uint32_t m_frames_received = 0;
+    sky::mcp_deframer m_deframers[MAX_CHANNEL]{sky::mcp_deframer{6}, sky::mcp_deframer{6}, sky::mcp_deframer{6}, sky::mcp_deframer{6}};
+};
+
+//The board, 16 lights with 8-bit ids, the paths take a quarter of the default topo's
+using node = basic_node<16, uint8_t>;
+//The simulator, a 16x16 grid. About 100 KB a node, too large for the board.
+using host_node = basic_node<256, uint16_t>;
+
+extern template class basic_node<16, uint8_t>;
+#ifndef ARDUINO
+extern template class basic_node<256, uint16_t>;
+#endif
+} // namespace ray
+
+#endif  // !SUNLIGHT_NODE_HPP
@@ -0,0 +1,80 @@
+/**
+ * @file   out_queue.cpp
+ * @author Pratchaya Khansomboon (me@mononerv.dev)
+ * @brief  Out queue of one multicom channel, optionally merging packets already waiting.
+ * @date   2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ */
+#include "out_queue.hpp"
+#include <cstring>
+
+#include "mcp.hpp"
+
+namespace ray {
+auto out_queue::is_urgent(packet const& pkt) noexcept -> bool {
+    if (pkt.size != sky::mcp_wire_size) return false;
+    auto const type = sky::mcp_view{pkt.data}.type();
+    return type == 3 || type == 4;
+}
+
+template <std::size_t SIZE>
+auto out_queue::push(sky::queue<entry, SIZE>& queue, packet const& pkt) noexcept -> void {
+    if (m_coalesce && pkt.size > 0) {
+        auto const last = pkt.size - 1u;
+        // Newest first, the copies of a flood are written back to back. The last byte of a
+        // frame is its CRC-16 trailer, so different frames nearly always differ there.
+        for (auto i = queue.size(); i-- > 0;) {
+            auto& waiting = queue.at(i);
+            if (waiting.pkt.size != pkt.size || waiting.pkt.data[last] != pkt.data[last]) continue;
+            if (std::memcmp(waiting.pkt.data, pkt.data, last) != 0) continue;
+            if (waiting.copies < max_copies) ++waiting.copies;
+            ++m_suppressed;
+            return;
+        }
+    }
+    queue.emplace(pkt, uint8_t{1});
+}
+
+template <std::size_t SIZE>
+auto out_queue::pop(sky::queue<entry, SIZE>& queue) noexcept -> void {
+    if (queue.empty()) return;
+    auto const front = queue.front();
+    queue.pop();
+    // Cannot overwrite, a place was just freed
+    if (front.copies > 1) queue.emplace(front.pkt, static_cast<uint8_t>(front.copies - 1));
+}
+
+auto out_queue::urgent_first() const noexcept -> bool {
+    if (m_urgent.empty()) return false;
+    return m_routine.empty() || m_run < urgent_run;
+}
+
+auto out_queue::push(packet const& pkt) noexcept -> void {
+    if (m_priority && is_urgent(pkt)) {
+        push(m_urgent, pkt);
+    } else {
+        push(m_routine, pkt);
+    }
+}
+
+auto out_queue::front() const noexcept -> packet const& {
+    return urgent_first() ? m_urgent.front().pkt : m_routine.front().pkt;
+}
+
+auto out_queue::pop() noexcept -> void {
+    if (urgent_first()) {
+        pop(m_urgent);
+        ++m_run;
+    } else {
+        pop(m_routine);
+        m_run = 0;
+    }
+}
+
+auto out_queue::clear() noexcept -> void {
+    m_routine.clear();
+    m_urgent.clear();
+    m_run = 0;
+}
+} // namespace ray
@@ -0,0 +1,79 @@
+/**
+ * @file   out_queue.hpp
+ * @author Pratchaya Khansomboon (me@mononerv.dev)
+ * @brief  Out queue of one multicom channel, optionally merging packets already waiting.
+ * @date   2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ */
+#ifndef SUNLIGHT_OUT_QUEUE_HPP
+#define SUNLIGHT_OUT_QUEUE_HPP
+#include <cstdint>
+#include <cstddef>
+
+#include "queue.hpp"
+#include "hal.hpp"
+
+namespace ray {
+/**
+ * @brief The node writes the same packet 8 or 16 times in a row to get it past lost slots,
+ *        which fills the queue and pushes out older, different packets. When coalescing, a
+ *        write of a packet that is still waiting only adds a copy to it. Copies go out one
+ *        per pop, and a packet with copies left moves to the back, so a flood takes one place
+ *        in the queue and takes turns with the rest.
+ *
+ *        With priorities on, fire and reset frames wait in a queue of their own and go out
+ *        before the routine traffic. After urgent_run of them in a row a routine packet that
+ *        is waiting gets its turn, so a burning node still passes on topology and exits.
+ */
+class out_queue {
+public:
+    static constexpr uint8_t     max_copies = 16;  // Largest flood the node writes
+    static constexpr std::size_t max_urgent = MAX_QUEUE / 2;
+    static constexpr std::size_t urgent_run = 4;
+
+    auto set_coalesce(bool coalesce) noexcept -> void { m_coalesce = coalesce; }
+    [[nodiscard]] auto coalesce() const noexcept -> bool { return m_coalesce; }
+    auto set_priority(bool priority) noexcept -> void { m_priority = priority; }
+    [[nodiscard]] auto priority() const noexcept -> bool { return m_priority; }
+
+    // Fire and reset frames, acknowledgements included.
+    [[nodiscard]] static auto is_urgent(packet const& pkt) noexcept -> bool;
+
+    // Overwrites the oldest packet of its class when full.
+    auto push(packet const& pkt) noexcept -> void;
+    // Only valid when not empty.
+    [[nodiscard]] auto front() const noexcept -> packet const&;
+    // Takes one copy of the front packet off the queue.
+    auto pop() noexcept -> void;
+
+    [[nodiscard]] auto empty() const noexcept -> bool { return m_routine.empty() && m_urgent.empty(); }
+    [[nodiscard]] auto size() const noexcept -> std::size_t { return m_routine.size() + m_urgent.size(); }
+    auto clear() noexcept -> void;
+
+    // Writes merged into a packet already waiting.
+    [[nodiscard]] auto suppressed() const noexcept -> std::size_t { return m_suppressed; }
+    // Packets lost to a write on a full queue, with all their copies.
+    [[nodiscard]] auto evicted() const noexcept -> std::size_t { return m_routine.overwritten() + m_urgent.overwritten(); }
+
+private:
+    struct entry {
+        packet  pkt{};
+        uint8_t copies = 1;
+    };
+    template <std::size_t SIZE>
+    auto push(sky::queue<entry, SIZE>& queue, packet const& pkt) noexcept -> void;
+    template <std::size_t SIZE>
+    static auto pop(sky::queue<entry, SIZE>& queue) noexcept -> void;
+    [[nodiscard]] auto urgent_first() const noexcept -> bool;
+
+    sky::queue<entry, MAX_QUEUE>  m_routine;
+    sky::queue<entry, max_urgent> m_urgent;
+    bool        m_coalesce   = false;
+    bool        m_priority   = false;
+    std::size_t m_run        = 0;  // Urgent packets sent since the last routine one
+    std::size_t m_suppressed = 0;
+};
+} // namespace ray
+
+#endif  // !SUNLIGHT_OUT_QUEUE_HPP
@@ -0,0 +1,55 @@
+/**
+ * @file   scheduler.cpp
+ * @author Pratchaya Khansomboon (me@mononerv.dev)
+ * @brief  Picks which channel multicom listens on next and for how long.
+ * @date   2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ */
+#include "scheduler.hpp"
+
+namespace ray {
+auto channel_scheduler::random(uint32_t min, uint32_t max) noexcept -> uint32_t {
+    m_state ^= m_state << 13;
+    m_state ^= m_state >> 17;
+    m_state ^= m_state << 5;
+    return max <= min ? min : min + m_state % (max - min);
+}
+
+auto round_robin_scheduler::next(uint8_t channel, slot_outcome, std::size_t const (&)[MAX_CHANNEL]) noexcept -> slot {
+    return {static_cast<uint8_t>((channel + 1) % MAX_CHANNEL), random(m_min, m_max)};
+}
+
+auto adaptive_scheduler::next(uint8_t channel, slot_outcome outcome, std::size_t const (&pending)[MAX_CHANNEL]) noexcept -> slot {
+    auto& current = m_channels[channel];
+    if (outcome.received) {
+        current.recent = recent;
+    } else if (current.recent > 0) {
+        --current.recent;
+    }
+    if (outcome.received || outcome.sent || pending[channel] > 0 || current.recent > 0) {
+        current.backoff = 0;
+    } else {
+        current.skip = current.backoff;
+        if (current.backoff < max_backoff) ++current.backoff;
+    }
+
+    auto next_channel = static_cast<uint8_t>((channel + 1) % MAX_CHANNEL);
+    for (std::size_t i = 1; i <= MAX_CHANNEL; ++i) {
+        auto const candidate = static_cast<uint8_t>((channel + i) % MAX_CHANNEL);
+        auto& state = m_channels[candidate];
+        // Output waiting ends the back off
+        if (pending[candidate] > 0) state.skip = 0;
+        if (state.skip == 0) {
+            next_channel = candidate;
+            break;
+        }
+        --state.skip;
+    }
+
+    auto const half = m_min + (m_max - m_min) / 2;
+    auto const& state = m_channels[next_channel];
+    if (pending[next_channel] == 0 && state.recent > 0) return {next_channel, random(m_min, m_max)};
+    return {next_channel, random(m_min, half)};
+}
+} // namespace ray
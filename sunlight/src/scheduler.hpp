@@ -0,0 +1,118 @@
+/**
+ * @file   scheduler.hpp
+ * @author Pratchaya Khansomboon (me@mononerv.dev)
+ * @brief  Picks which channel multicom listens on next and for how long.
+ * @date   2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ */
+#ifndef SUNLIGHT_SCHEDULER_HPP
+#define SUNLIGHT_SCHEDULER_HPP
+#include <cstdint>
+#include <cstddef>
+
+#include "hal.hpp"
+
+namespace ray {
+// multicom listens on a channel for interval_us, then reads what arrived or sends one packet.
+struct slot {
+    uint8_t  channel     = 0;
+    uint32_t interval_us = 0;
+};
+
+// What happened in the slot that just ended.
+struct slot_outcome {
+    bool received = false;
+    bool sent     = false;
+};
+
+// Per channel traffic since start, the out queue counts and depths are taken when asked.
+struct channel_counters {
+    uint32_t    slots       = 0;
+    uint32_t    packets_in  = 0;
+    uint32_t    bytes_in    = 0;
+    uint32_t    packets_out = 0;
+    uint32_t    bytes_out   = 0;
+    std::size_t suppressed  = 0;  // Writes merged into a packet already queued
+    std::size_t evicted     = 0;  // Queued packets lost to a write on a full out queue
+    std::size_t in_depth    = 0;
+    std::size_t out_depth   = 0;
+};
+
+/**
+ * @brief Slot policy of multicom. Intervals are never shorter than min_us, the other end
+ *        of a link needs that long to come round to the channel.
+ */
+class channel_scheduler {
+public:
+    channel_scheduler(uint32_t min_us, uint32_t max_us) noexcept : m_min(min_us), m_max(max_us) {}
+    virtual ~channel_scheduler() = default;
+
+    // Slot after the one on channel ended, pending holds the out queue depth of every channel.
+    virtual auto next(uint8_t channel, slot_outcome outcome, std::size_t const (&pending)[MAX_CHANNEL]) noexcept -> slot = 0;
+    // Fewest slots from ending one on channel from to ending one on channel to, 0 when equal.
+    [[nodiscard]] virtual auto min_slots(uint8_t from, uint8_t to) const noexcept -> std::size_t { return from == to ? 0 : 1; }
+    // Longest a slot is kept open past its interval while a packet is still coming in, 0 never.
+    [[nodiscard]] virtual auto linger_us() const noexcept -> uint32_t { return 0; }
+
+    // First slot after start.
+    auto first() noexcept -> slot { return {0, random(m_min, m_max)}; }
+    auto seed(uint32_t value) noexcept -> void { m_state = value == 0 ? 1 : value; }
+
+    [[nodiscard]] auto min_us() const noexcept -> uint32_t { return m_min; }
+    [[nodiscard]] auto max_us() const noexcept -> uint32_t { return m_max; }
+
+protected:
+    // In [min, max), xorshift32 so a seeded host run repeats.
+    auto random(uint32_t min, uint32_t max) noexcept -> uint32_t;
+
+    uint32_t m_min;
+    uint32_t m_max;
+
+private:
+    uint32_t m_state = 1;
+};
+
+// Every channel in turn for random(min, max), what multicom always did.
+class round_robin_scheduler final : public channel_scheduler {
+public:
+    explicit round_robin_scheduler(uint32_t min_us = 16000, uint32_t max_us = 66000) noexcept
+        : channel_scheduler(min_us, max_us) {}
+
+    auto next(uint8_t channel, slot_outcome outcome, std::size_t const (&pending)[MAX_CHANNEL]) noexcept -> slot override;
+    [[nodiscard]] auto min_slots(uint8_t from, uint8_t to) const noexcept -> std::size_t override {
+        return (to + MAX_CHANNEL - from) % MAX_CHANNEL;
+    }
+};
+
+/**
+ * @brief Spends the time where the traffic is. A channel with output waiting gets a short
+ *        slot so the packet goes out soon. A channel that received lately is listened to for
+ *        a full slot. A channel that stays silent is skipped for up to max_backoff rounds.
+ *        Skipped channels are still visited, so a neighbour that starts talking is heard
+ *        within a few rounds.
+ */
+class adaptive_scheduler final : public channel_scheduler {
+public:
+    static constexpr uint8_t max_backoff = 2;
+    static constexpr uint8_t recent      = 4;  // Visits a channel counts as active after input
+
+    // Default linger is a whole frame at 9600 baud
+    explicit adaptive_scheduler(uint32_t min_us = 16000, uint32_t max_us = 66000, uint32_t linger_us = 26000) noexcept
+        : channel_scheduler(min_us, max_us), m_linger(linger_us) {}
+
+    auto next(uint8_t channel, slot_outcome outcome, std::size_t const (&pending)[MAX_CHANNEL]) noexcept -> slot override;
+    [[nodiscard]] auto linger_us() const noexcept -> uint32_t override { return m_linger; }
+
+private:
+    struct channel_state {
+        uint8_t recent  = 0;  // Visits left counting as active
+        uint8_t backoff = 0;  // Rounds to skip after the next silent visit
+        uint8_t skip    = 0;  // Rounds still to skip
+    };
+    uint32_t m_linger;
+    channel_state m_channels[MAX_CHANNEL]{};
+};
+} // namespace ray
+
+#endif  // !SUNLIGHT_SCHEDULER_HPP
@@ -0,0 +1,88 @@
+/**
+ * @file   trace.hpp
+ * @author Pratchaya Khansomboon (me@mononerv.dev)
+ * @brief  Binary trace of the packets a node reads and writes, for replay on the host.
+ * @date   2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * A trace is an 8 byte header, "SLT1" and the little endian node address, followed by
+ * records of 6 + size bytes:
+ *
+ *   time    4 bytes, millis() of the node, little endian
+ *   channel 1 byte, bit 7 set when the node wrote the packet
+ *   size    1 byte, at most 32
+ *   data    size bytes
+ */
+#ifndef SUNLIGHT_TRACE_HPP
+#define SUNLIGHT_TRACE_HPP
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+#include "hal.hpp"
+
+namespace ray {
+constexpr uint8_t     trace_magic[4]      = {'S', 'L', 'T', '1'};
+constexpr std::size_t trace_header_size   = 8;
+constexpr std::size_t trace_record_header = 6;
+constexpr std::size_t trace_record_max    = trace_record_header + sizeof(packet::data);
+
+struct trace_record {
+    uint32_t time = 0;
+    bool     sent = false;  // Written by the node, read otherwise
+    packet   pkt{};
+};
+
+// Hook called by the channels for every packet the node reads or writes.
+class recorder {
+public:
+    virtual ~recorder() = default;
+    virtual auto record(trace_record const& rec) noexcept -> void = 0;
+};
+
+// Writes the header to out, which has room for trace_header_size bytes.
+inline auto encode_trace_header(uint8_t* out, uint32_t address) noexcept -> std::size_t {
+    std::memcpy(out, trace_magic, sizeof(trace_magic));
+    for (std::size_t i = 0; i < 4; ++i) out[4 + i] = static_cast<uint8_t>(address >> (8 * i));
+    return trace_header_size;
+}
+
+// Node address of the trace, false when data does not start with a header.
+inline auto decode_trace_header(uint8_t const* data, std::size_t size, uint32_t& address) noexcept -> bool {
+    if (size < trace_header_size || std::memcmp(data, trace_magic, sizeof(trace_magic)) != 0) return false;
+    address = 0;
+    for (std::size_t i = 0; i < 4; ++i) address |= static_cast<uint32_t>(data[4 + i]) << (8 * i);
+    return true;
+}
+
+// Writes the record to out, which has room for trace_record_max bytes.
+inline auto encode_trace_record(uint8_t* out, trace_record const& rec) noexcept -> std::size_t {
+    auto const size = rec.pkt.size < sizeof(rec.pkt.data) ? rec.pkt.size : sizeof(rec.pkt.data);
+    for (std::size_t i = 0; i < 4; ++i) out[i] = static_cast<uint8_t>(rec.time >> (8 * i));
+    out[4] = static_cast<uint8_t>((rec.pkt.channel & 0x7F) | (rec.sent ? 0x80 : 0x00));
+    out[5] = static_cast<uint8_t>(size);
+    std::memcpy(out + trace_record_header, rec.pkt.data, size);
+    return trace_record_header + size;
+}
+
+/**
+ * @brief Reads one record from the front of data.
+ * @return Bytes used, 0 when the record is cut short or malformed.
+ */
+inline auto decode_trace_record(uint8_t const* data, std::size_t size, trace_record& rec) noexcept -> std::size_t {
+    if (size < trace_record_header) return 0;
+    auto const length = data[5];
+    if (length > sizeof(rec.pkt.data) || (data[4] & 0x7F) >= MAX_CHANNEL) return 0;
+    if (size < trace_record_header + length) return 0;
+    rec.time = 0;
+    for (std::size_t i = 0; i < 4; ++i) rec.time |= static_cast<uint32_t>(data[i]) << (8 * i);
+    rec.sent        = (data[4] & 0x80) != 0;
+    rec.pkt.channel = static_cast<uint8_t>(data[4] & 0x7F);
+    rec.pkt.size    = length;
+    std::memcpy(rec.pkt.data, data + trace_record_header, length);
+    return trace_record_header + length;
+}
+} // namespace ray
+
+#endif  // !SUNLIGHT_TRACE_HPP
@@ -0,0 +1,81 @@
+/**
+ * @file   address_map_tests.hpp
+ * @author Pratchaya Khansomboon (me@mononerv.dev)
+ * @brief  Address to index table tests.
+ * @date   2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ */
+#ifndef TESTS_ADDRESS_MAP_TESTS_HPP
+#define TESTS_ADDRESS_MAP_TESTS_HPP
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <unordered_set>
+
+#include "gtest/gtest.h"
+#include "address_map.hpp"
+
+TEST(sky_address_map, insert_and_find) {
+    sky::address_map<4> map{};
+    sky::address_t const a{0x01, 0x02, 0x03};
+    sky::address_t const b{0xAB, 0xCD, 0xEF};
+    sky::address_t const zero{0, 0, 0};
+
+    EXPECT_EQ(map.find(a), map.npos);
+    EXPECT_EQ(map.insert(a), 0u);
+    EXPECT_EQ(map.insert(b), 1u);
+    EXPECT_EQ(map.insert(a), 0u);  // Already there
+    EXPECT_EQ(map.insert(zero), map.npos);
+    EXPECT_EQ(map.size(), 2u);
+
+    EXPECT_EQ(map.find(b), 1u);
+    EXPECT_EQ(map.find(sky::mcp_address_to_u32(a)), 0u);
+    EXPECT_EQ(map.find(zero), map.npos);
+    EXPECT_EQ(map[1][0], 0xAB);
+    EXPECT_EQ(map[2][0], 0x00);
+
+    map.clear();
+    EXPECT_EQ(map.size(), 0u);
+    EXPECT_EQ(map.find(a), map.npos);
+    EXPECT_EQ(map[0][0], 0x00);
+}
+
+TEST(sky_address_map, full) {
+    sky::address_map<3> map{};
+    for (std::uint8_t i = 1; i <= 3; ++i) {
+        sky::address_t const address{0, 0, i};
+        EXPECT_EQ(map.insert(address), i - 1u);
+    }
+    sky::address_t const address{0, 0, 4};
+    EXPECT_EQ(map.insert(address), map.npos);
+    sky::address_t const known{0, 0, 2};
+    EXPECT_EQ(map.insert(known), 1u);
+}
+
+TEST(sky_address_map, many_addresses) {
+    constexpr std::size_t count = 4096;
+    auto map = std::make_unique<sky::address_map<count>>();
+    std::mt19937 rng{9};
+    std::unordered_set<std::uint32_t> used{};
+    std::uint32_t keys[count]{};
+    for (std::size_t i = 0; i < count; ++i) {
+        std::uint32_t key = 0;
+        while (key == 0 || used.count(key) != 0) key = static_cast<std::uint32_t>(rng() & 0xFFFFFF);
+        used.insert(key);
+        keys[i] = key;
+        sky::address_t address{};
+        sky::mcp_u32_to_address(address, key);
+        ASSERT_EQ(map->insert(address), i);
+    }
+    for (std::size_t i = 0; i < count; ++i) EXPECT_EQ(map->find(keys[i]), i);
+    for (int i = 0; i < 1000; ++i) {
+        auto const key = static_cast<std::uint32_t>(rng() & 0xFFFFFF);
+        if (used.count(key) == 0) {
+            EXPECT_EQ(map->find(key), map->npos);
+        }
+    }
+}
+
+#endif  // !TESTS_ADDRESS_MAP_TESTS_HPP
@@ -0,0 +1,71 @@
+/**
+ * @file   crc_tests.hpp
+ * @author Pratchaya Khansomboon (me@mononerv.dev)
+ * @brief  Check CRC-8 kernels against the bitwise reference implementation, and the CRC-16.
+ * @date   2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ */
+#ifndef TESTS_CRC_TESTS_HPP
+#define TESTS_CRC_TESTS_HPP
+
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "crc.hpp"
+#include "utility.hpp"
+
+template <std::uint8_t POLY>
+static auto crc_kernels_match_reference() -> void {
+    std::mt19937 rng{POLY};
+    std::uniform_int_distribution<int> byte{0, 255};
+    for (std::size_t size = 0; size < 300; ++size) {
+        std::vector<std::uint8_t> data(size);
+        for (auto& b : data) b = static_cast<std::uint8_t>(byte(rng));
+
+        auto const expected = sky::crc_8_bitwise<POLY>(data.data(), size);
+        EXPECT_EQ(expected, sky::crc_8_table<POLY>(data.data(), size))   << "size: " << size;
+        EXPECT_EQ(expected, sky::crc_8_slice_4<POLY>(data.data(), size)) << "size: " << size;
+        EXPECT_EQ(expected, sky::crc_8_slice_8<POLY>(data.data(), size)) << "size: " << size;
+        EXPECT_EQ(expected, sky::crc_8<POLY>(data.data(), size))         << "size: " << size;
+    }
+}
+
+TEST(sky_crc, kernels_match_bitwise_poly_07) {
+    crc_kernels_match_reference<0x07>();
+}
+
+TEST(sky_crc, kernels_match_bitwise_other_polys) {
+    crc_kernels_match_reference<0x31>();
+    crc_kernels_match_reference<0x1D>();
+    crc_kernels_match_reference<0x9B>();
+}
+
+TEST(sky_crc, continue_from_register) {
+    std::uint8_t const data[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13};
+    auto const head = sky::crc_8_table(data, 5);
+    EXPECT_EQ(sky::crc_8_bitwise(data, sky::length_of(data)), sky::crc_8_slice_8(data + 5, sky::length_of(data) - 5, head));
+}
+
+TEST(sky_crc, table_is_compile_time) {
+    static_assert(sky::crc_8_lut<0x07>.table[0][1] == 0x07);
+    constexpr std::uint8_t data[] = {0x01, 0x02};
+    static_assert(sky::crc_8_table(data, 2) == sky::crc_8_bitwise(data, 2));
+}
+
+TEST(sky_crc, crc_16_ccitt) {
+    std::uint8_t const check[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+    EXPECT_EQ(sky::crc_16_bitwise(check, sky::length_of(check)), 0x29B1);
+    EXPECT_EQ(sky::crc_16_table(check, sky::length_of(check)), 0x29B1);
+
+    std::mt19937 rng{16};
+    std::uniform_int_distribution<int> byte{0, 255};
+    std::vector<std::uint8_t> data(300);
+    for (auto& b : data) b = static_cast<std::uint8_t>(byte(rng));
+    for (std::size_t size = 0; size < data.size(); ++size) {
+        EXPECT_EQ(sky::crc_16_bitwise(data.data(), size), sky::crc_16_table(data.data(), size)) << "size: " << size;
+    }
+}
+
+#endif  // !TESTS_CRC_TESTS_HPP
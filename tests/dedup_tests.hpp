@@ -0,0 +1,59 @@
+/**
+ * @file   dedup_tests.hpp
+ * @author Pratchaya Khansomboon (me@mononerv.dev)
+ * @brief  Duplicate frame cache tests.
+ * @date   2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ */
+#ifndef TESTS_DEDUP_TESTS_HPP
+#define TESTS_DEDUP_TESTS_HPP
+
+#include "gtest/gtest.h"
+#include "dedup.hpp"
+
+static auto dedup_make_frame(sky::mcp_buffer_t& buffer, std::uint32_t source, std::uint8_t sequence) -> sky::mcp_view {
+    sky::mcp msg{ 1, {}, {0x04, 0x05, 0x06}, {}, sequence, 0 };
+    sky::mcp_u32_to_address(msg.source, source);
+    sky::mcp_make_buffer(buffer, msg);
+    return sky::mcp_view{buffer};
+}
+
+TEST(sky_dedup, drops_flooded_copies) {
+    sky::mcp_dedup_cache<> cache{};
+    sky::mcp_buffer_t buffer{};
+    auto const frame = dedup_make_frame(buffer, 0xABCDEF, 7);
+
+    EXPECT_FALSE(cache.is_duplicate(frame));
+    for (auto i = 0; i < 15; ++i) EXPECT_TRUE(cache.is_duplicate(frame));
+
+    // Destination is rewritten on every hop, the copy is still the same frame
+    sky::mcp_mut_view{buffer}.set_destination({0x10, 0x11, 0x12});
+    EXPECT_TRUE(cache.is_duplicate(frame));
+
+    EXPECT_EQ(cache.stats().accepted, 1u);
+    EXPECT_EQ(cache.stats().duplicates, 16u);
+}
+
+TEST(sky_dedup, new_sequence_or_source_is_accepted) {
+    sky::mcp_dedup_cache<> cache{};
+    sky::mcp_buffer_t buffer{};
+    EXPECT_FALSE(cache.is_duplicate(dedup_make_frame(buffer, 0x000001, 0)));
+    EXPECT_FALSE(cache.is_duplicate(dedup_make_frame(buffer, 0x000001, 1)));
+    EXPECT_FALSE(cache.is_duplicate(dedup_make_frame(buffer, 0x000002, 0)));
+    EXPECT_TRUE(cache.is_duplicate(dedup_make_frame(buffer, 0x000001, 1)));
+    EXPECT_EQ(cache.stats().accepted, 3u);
+    EXPECT_EQ(cache.stats().duplicates, 1u);
+}
+
+TEST(sky_dedup, wrapped_sequence_is_not_a_duplicate) {
+    sky::mcp_dedup_cache<16> cache{};
+    sky::mcp_buffer_t buffer{};
+    for (auto round = 0; round < 2; ++round) {
+        for (std::uint32_t seq = 0; seq < 256; ++seq)
+            EXPECT_FALSE(cache.is_duplicate(dedup_make_frame(buffer, 0x123456, static_cast<std::uint8_t>(seq))));
+    }
+    EXPECT_EQ(cache.stats().duplicates, 0u);
+}
+
+#endif  // !TESTS_DEDUP_TESTS_HPP
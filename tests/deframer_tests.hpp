@@ -0,0 +1,135 @@
+/**
+ * @file   deframer_tests.hpp
+ * @author Pratchaya Khansomboon (me@mononerv.dev)
+ * @brief  Streaming deframer tests.
+ * @date   2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ */
+#ifndef TESTS_DEFRAMER_TESTS_HPP
+#define TESTS_DEFRAMER_TESTS_HPP
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "deframer.hpp"
+
+static auto deframer_make_stream(std::size_t count) -> std::vector<std::uint8_t> {
+    std::vector<std::uint8_t> stream;
+    for (std::size_t i = 0; i < count; ++i) {
+        sky::mcp msg{ static_cast<std::uint8_t>(i % 6), {0x01, 0x02, static_cast<std::uint8_t>(i)}, {0x04, 0x05, 0x06}, {static_cast<std::uint8_t>(i)}, 0, 0 };
+        sky::mcp_buffer_t buffer{};
+        sky::mcp_make_buffer(buffer, msg);
+        sky::mcp_wire_t wire{};
+        sky::mcp_make_wire(wire, buffer);
+        stream.insert(stream.end(), wire, wire + sky::mcp_wire_size);
+    }
+    return stream;
+}
+
+TEST(sky_deframer, back_to_back_frames_in_one_chunk) {
+    auto const stream = deframer_make_stream(5);
+    sky::mcp_deframer deframer{};
+    std::vector<std::uint8_t> sources;
+    deframer.push(stream.data(), stream.size(), [&](sky::mcp_view const& frame) {
+        sources.push_back(frame.source()[2]);
+    });
+    EXPECT_EQ(sources, (std::vector<std::uint8_t>{0, 1, 2, 3, 4}));
+    EXPECT_EQ(deframer.stats().frames, 5u);
+    EXPECT_EQ(deframer.stats().dropped_bytes, 0u);
+    EXPECT_EQ(deframer.buffered(), 0u);
+}
+
+TEST(sky_deframer, frames_split_across_chunks) {
+    auto const stream = deframer_make_stream(20);
+    std::mt19937 rng{5};
+    std::uniform_int_distribution<std::size_t> chunk{1, 40};
+    sky::mcp_deframer deframer{};
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < stream.size();) {
+        auto const n = std::min(chunk(rng), stream.size() - i);
+        deframer.push(stream.data() + i, n, [&](sky::mcp_view const& frame) {
+            EXPECT_EQ(frame.source()[2], count);
+            ++count;
+        });
+        i += n;
+    }
+    EXPECT_EQ(count, 20u);
+    EXPECT_EQ(deframer.stats().resyncs, 0u);
+}
+
+TEST(sky_deframer, resync_after_noise_and_truncated_frame) {
+    auto stream = deframer_make_stream(4);
+    // Noise in front, frame 1 cut short by 5 bytes
+    stream.erase(stream.begin() + sky::mcp_wire_size, stream.begin() + sky::mcp_wire_size + 5);
+    stream.insert(stream.begin(), {0xFF, 0xFE, 0xFD});
+
+    sky::mcp_deframer deframer{6};
+    std::vector<std::uint8_t> sources;
+    deframer.push(stream.data(), stream.size(), [&](sky::mcp_view const& frame) {
+        sources.push_back(frame.source()[2]);
+    });
+    EXPECT_EQ(sources, (std::vector<std::uint8_t>{0, 2, 3}));
+    EXPECT_EQ(deframer.stats().frames, 3u);
+    EXPECT_EQ(deframer.stats().resyncs, 2u);
+    EXPECT_EQ(deframer.stats().dropped_bytes, 3u + sky::mcp_wire_size - 5);
+}
+
+TEST(sky_deframer, frame_without_trailer_is_noise) {
+    sky::mcp msg{ 3, {0x01, 0x02, 0x03}, {0x04, 0x05, 0x06}, {0}, 0, 0 };
+    sky::mcp_buffer_t buffer{};
+    sky::mcp_make_buffer(buffer, msg);
+    std::vector<std::uint8_t> stream(buffer, buffer + sky::mcp_buffer_size);
+    stream.insert(stream.end(), {0x00, 0x00});
+
+    sky::mcp_deframer deframer{6};
+    deframer.push(stream.data(), stream.size(), [](sky::mcp_view const&) { FAIL(); });
+    EXPECT_EQ(deframer.stats().frames, 0u);
+}
+
+// Real traffic with frames cut short, like a slot that ends in the middle of one. Every byte
+// after a cut starts a window over the ends of two frames. A cut frame can come out when the
+// bytes in front of it happen to be the ones it lost, but never anything that was not sent.
+TEST(sky_deframer, shifted_windows_do_not_pass) {
+    std::mt19937 rng{11};
+    std::uniform_int_distribution<int> byte{0, 255};
+    std::uniform_int_distribution<std::size_t> cut{1, sky::mcp_wire_size - 1};
+    std::vector<std::uint8_t> stream;
+    std::vector<sky::mcp> sent;
+    std::vector<std::uint32_t> whole;
+    for (std::uint32_t i = 0; i < 100'000; ++i) {
+        sky::mcp msg{ static_cast<std::uint8_t>(byte(rng) % 6), {}, {}, {}, static_cast<std::uint8_t>(i), 0 };
+        for (auto& b : msg.source) b = static_cast<std::uint8_t>(byte(rng));
+        for (auto& b : msg.destination) b = static_cast<std::uint8_t>(byte(rng));
+        for (std::size_t k = 0; k < 4; ++k) msg.payload[k] = static_cast<std::uint8_t>(byte(rng));
+        std::memcpy(msg.payload + 4, &i, sizeof(i));
+        sky::mcp_buffer_t buffer{};
+        sky::mcp_make_buffer(buffer, msg);
+        sent.push_back(sky::mcp_make_from_buffer(buffer));
+        sky::mcp_wire_t wire{};
+        sky::mcp_make_wire(wire, buffer);
+        if (byte(rng) < 128) {
+            stream.insert(stream.end(), wire, wire + sky::mcp_wire_size);
+            whole.push_back(i);
+        } else {
+            stream.insert(stream.end(), wire + cut(rng), wire + sky::mcp_wire_size);
+        }
+    }
+
+    sky::mcp_deframer deframer{6};
+    std::vector<std::uint32_t> received;
+    deframer.push(stream.data(), stream.size(), [&](sky::mcp_view const& frame) {
+        std::uint32_t index = 0;
+        std::memcpy(&index, frame.payload() + 4, sizeof(index));
+        ASSERT_LT(index, sent.size());
+        EXPECT_EQ(std::memcmp(frame.data(), &sent[index], sky::mcp_buffer_size), 0) << "frame: " << index;
+        received.push_back(index);
+    });
+    EXPECT_GT(deframer.stats().dropped_bytes, 500'000u);
+    EXPECT_TRUE(std::includes(received.begin(), received.end(), whole.begin(), whole.end()));
+}
+
+#endif  // !TESTS_DEFRAMER_TESTS_HPP
@@ -0,0 +1,192 @@
+/**
+ * @file   exit_tree_tests.hpp
+ * @author Pratchaya Khansomboon (me@mononerv.dev)
+ * @brief  Incremental exit tree against a full rebuild.
+ * @date   2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ */
+#ifndef TESTS_EXIT_TREE_TESTS_HPP
+#define TESTS_EXIT_TREE_TESTS_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <random>
+
+#include "gtest/gtest.h"
+#include "exit_tree.hpp"
+
+namespace exit_tree_test {
+using sky::topo_index_t;
+constexpr std::uint32_t side  = 8;
+constexpr std::uint32_t nodes = side * side;
+using topo_t = sky::sparse_topo<nodes, nodes * 4>;
+using tree_t = sky::exit_tree<nodes, nodes * 4>;
+
+// Grid with random costs 1-4.
+inline auto grid(topo_t& topology, std::mt19937& rng) -> void {
+    std::uniform_int_distribution<int> cost(1, 4);
+    sky::sparse_topo_clear(topology);
+    for (std::uint32_t i = 0; i < nodes; ++i) {
+        if ((i % side) + 1 < side) sky::sparse_topo_set_node_link_cost(topology, i, i + 1, static_cast<std::int8_t>(cost(rng)));
+        if (i + side < nodes) sky::sparse_topo_set_node_link_cost(topology, i, i + side, static_cast<std::int8_t>(cost(rng)));
+    }
+}
+
+// Distances equal a full rebuild, changed() lists exactly the nodes with a new next hop
+// and every path leads to the exit.
+inline auto expect_same(topo_t const& topology, tree_t const& tree, topo_index_t const* before) -> void {
+    std::uint32_t exits[nodes]{};
+    std::copy(tree.exits(), tree.exits() + tree.exit_count(), exits);
+    auto fresh = std::make_unique<tree_t>();
+    fresh->build(topology, exits, tree.exit_count());
+
+    bool changed[nodes]{};
+    for (std::size_t i = 0; i < tree.changed_count(); ++i) changed[tree.changed()[i]] = true;
+
+    std::uint32_t path[nodes]{};
+    for (std::uint32_t i = 0; i < nodes; ++i) {
+        EXPECT_EQ(tree.distance(i), fresh->distance(i)) << "node " << i;
+        EXPECT_EQ(changed[i], tree.next(i) != before[i]) << "node " << i;
+        auto const length = tree.path(i, path, nodes);
+        if (tree.distance(i) < 0) {
+            EXPECT_EQ(length, 0u);
+            continue;
+        }
+        ASSERT_GT(length, 0u);
+        EXPECT_EQ(path[0], i);
+        EXPECT_TRUE(tree.is_exit(path[length - 1]));
+        EXPECT_EQ(path[length - 1], tree.nearest_exit(i));
+    }
+}
+} // namespace exit_tree_test
+
+TEST(sky_exit_tree, build_matches_dijkstra) {
+    using namespace exit_tree_test;
+    std::mt19937 rng{1};
+    auto topology = std::make_unique<topo_t>();
+    auto tree = std::make_unique<tree_t>();
+    grid(*topology, rng);
+    tree->build(*topology, nodes - 1);
+    EXPECT_EQ(tree->changed_count(), nodes);
+
+    std::uint32_t path[nodes]{};
+    for (std::uint32_t i = 0; i < nodes; ++i) {
+        auto const length = sky::sparse_topo_compute_dijkstra(*topology, i, nodes - 1, path, nodes);
+        std::int32_t cost = 0;
+        for (std::size_t k = 1; k < length; ++k)
+            cost += topology->cost[sky::detail::sparse_topo_find(*topology, path[k - 1], path[k])];
+        EXPECT_EQ(tree->distance(i), cost);
+    }
+}
+
+TEST(sky_exit_tree, random_fire_and_reset) {
+    using namespace exit_tree_test;
+    std::mt19937 rng{7};
+    std::uniform_int_distribution<std::uint32_t> pick(0, nodes - 1);
+    std::uniform_int_distribution<int> cost(1, 4);
+    auto topology = std::make_unique<topo_t>();
+    auto tree = std::make_unique<tree_t>();
+    topo_index_t before[nodes]{};
+
+    for (int round = 0; round < 8; ++round) {
+        grid(*topology, rng);
+        tree->build(*topology, pick(rng));
+        for (int step = 0; step < 24; ++step) {
+            for (std::uint32_t i = 0; i < nodes; ++i) before[i] = tree->next(i);
+            auto const node = pick(rng);
+            if (!topology->fire[node]) {
+                tree->set_node_firemode(*topology, node);
+            } else {
+                // Reset re-adds the node with its grid links
+                tree->clear_node_firemode(*topology, node);
+                expect_same(*topology, *tree, before);
+                auto const x = node % side;
+                std::uint32_t const neighbours[] = {x > 0 ? node - 1 : nodes, x + 1 < side ? node + 1 : nodes,
+                                                    node >= side ? node - side : nodes, node + side};
+                for (auto const other : neighbours) {
+                    if (other >= nodes || topology->fire[other]) continue;
+                    for (std::uint32_t i = 0; i < nodes; ++i) before[i] = tree->next(i);
+                    EXPECT_TRUE(tree->set_node_link_cost(*topology, node, other, static_cast<std::int8_t>(cost(rng))));
+                    expect_same(*topology, *tree, before);
+                }
+                continue;
+            }
+            expect_same(*topology, *tree, before);
+        }
+    }
+}
+
+TEST(sky_exit_tree, exit_in_firemode) {
+    using namespace exit_tree_test;
+    std::mt19937 rng{5};
+    auto topology = std::make_unique<topo_t>();
+    auto tree = std::make_unique<tree_t>();
+    grid(*topology, rng);
+    tree->build(*topology, 9);
+
+    tree->set_node_firemode(*topology, 9);
+    EXPECT_EQ(tree->changed_count(), nodes);
+    for (std::uint32_t i = 0; i < nodes; ++i) EXPECT_EQ(tree->distance(i), -1);
+
+    tree->clear_node_firemode(*topology, 9);
+    EXPECT_EQ(tree->distance(9), 0);
+    EXPECT_EQ(tree->distance(10), -1);
+    EXPECT_TRUE(tree->set_node_link_cost(*topology, 9, 10, 1));
+    EXPECT_EQ(tree->distance(10), 1);
+    EXPECT_EQ(tree->distance(11), 1 + topology->cost[sky::detail::sparse_topo_find(*topology, 10, 11)]);
+}
+
+TEST(sky_exit_tree, nearest_of_several_exits) {
+    using namespace exit_tree_test;
+    std::mt19937 rng{11};
+    std::uniform_int_distribution<std::uint32_t> pick(0, nodes - 1);
+    auto topology = std::make_unique<topo_t>();
+    auto tree = std::make_unique<tree_t>();
+    auto single = std::make_unique<tree_t>();
+    topo_index_t before[nodes]{};
+
+    for (int round = 0; round < 8; ++round) {
+        grid(*topology, rng);
+        std::uint32_t const exits[] = {pick(rng), pick(rng), pick(rng)};
+        tree->build(*topology, exits, 3);
+        // Same as the closest of one tree per exit
+        for (std::uint32_t i = 0; i < nodes; ++i) {
+            std::int32_t best = -1;
+            for (auto const exit : exits) {
+                single->build(*topology, exit);
+                auto const distance = single->distance(i);
+                if (best < 0 || distance < best) best = distance;
+            }
+            EXPECT_EQ(tree->distance(i), best) << "node " << i;
+        }
+        for (int step = 0; step < 8; ++step) {
+            for (std::uint32_t i = 0; i < nodes; ++i) before[i] = tree->next(i);
+            tree->set_node_firemode(*topology, pick(rng));
+            expect_same(*topology, *tree, before);
+        }
+    }
+}
+
+TEST(sky_exit_tree, random_link_changes) {
+    using namespace exit_tree_test;
+    std::mt19937 rng{3};
+    std::uniform_int_distribution<std::uint32_t> pick(0, nodes - 1);
+    std::uniform_int_distribution<int> cost(-1, 6);
+    auto topology = std::make_unique<topo_t>();
+    auto tree = std::make_unique<tree_t>();
+    topo_index_t before[nodes]{};
+
+    grid(*topology, rng);
+    tree->build(*topology, 0);
+    for (int step = 0; step < 400; ++step) {
+        auto const node = pick(rng);
+        auto const other = rng() % 2 == 0 ? (node + 1) % nodes : (node + side) % nodes;
+        for (std::uint32_t i = 0; i < nodes; ++i) before[i] = tree->next(i);
+        tree->set_node_link_cost(*topology, node, other, static_cast<std::int8_t>(cost(rng)));
+        expect_same(*topology, *tree, before);
+    }
+}
+
+#endif  // !TESTS_EXIT_TREE_TESTS_HPP
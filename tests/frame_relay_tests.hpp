@@ -0,0 +1,114 @@
+/**
+ * @file   frame_relay_tests.hpp
+ * @author Pratchaya Khansomboon (me@mononerv.dev)
+ * @brief  Sandbox frame hand-off tests, deframe on one thread and encode on another.
+ * @date   2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ */
+#ifndef TESTS_FRAME_RELAY_TESTS_HPP
+#define TESTS_FRAME_RELAY_TESTS_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "../shelter/frame_relay.hpp"
+
+static auto frame_relay_make_wire(std::uint32_t index) -> std::vector<std::uint8_t> {
+    sky::mcp msg{ static_cast<std::uint8_t>(index % 6), {0x01, 0x02, 0x03}, {0x04, 0x05, 0x06}, {}, 0, 0 };
+    std::memcpy(msg.payload, &index, sizeof(index));
+    sky::mcp_buffer_t buffer{};
+    sky::mcp_make_buffer(buffer, msg);
+    sky::mcp_wire_t wire{};
+    sky::mcp_make_wire(wire, buffer);
+    return {wire, wire + sky::mcp_wire_size};
+}
+
+TEST(shelter_frame_relay, encodes_the_frames_it_was_fed) {
+    sky::mcp_deframer deframer{};
+    flicker::frame_queue_t queue{};
+    std::vector<std::uint8_t> stream{0xFF, 0xFE};  // Noise is skipped
+    for (std::uint32_t i = 0; i < 3; ++i) {
+        auto const wire = frame_relay_make_wire(i);
+        stream.insert(stream.end(), wire.begin(), wire.end());
+    }
+    // Split in the middle of a frame, like two socket reads
+    EXPECT_EQ(flicker::relay_frames(deframer, queue, stream.data(), 40), 0u);
+    EXPECT_EQ(queue.size(), 1u);
+    EXPECT_EQ(flicker::relay_frames(deframer, queue, stream.data() + 40, stream.size() - 40), 0u);
+
+    sky::mcp frame{};
+    for (std::uint32_t i = 0; i < 3; ++i) {
+        ASSERT_TRUE(queue.try_deq(frame));
+        sky::mcp_wire_t wire{};
+        flicker::encode_frame(wire, frame);
+        EXPECT_EQ(std::vector<std::uint8_t>(wire, wire + sky::mcp_wire_size), frame_relay_make_wire(i));
+    }
+    EXPECT_FALSE(queue.try_deq(frame));
+}
+
+TEST(shelter_frame_relay, counts_frames_dropped_when_full) {
+    sky::mcp_deframer deframer{};
+    flicker::frame_queue_t queue{};
+    std::vector<std::uint8_t> stream;
+    for (std::uint32_t i = 0; i < queue.capacity() + 10; ++i) {
+        auto const wire = frame_relay_make_wire(i);
+        stream.insert(stream.end(), wire.begin(), wire.end());
+    }
+    EXPECT_EQ(flicker::relay_frames(deframer, queue, stream.data(), stream.size()), 10u);
+    EXPECT_EQ(queue.size(), queue.capacity());
+}
+
+TEST(shelter_frame_relay, network_and_consumer_threads) {
+    constexpr std::uint32_t count = 20000;
+    std::vector<std::uint8_t> stream;
+    for (std::uint32_t i = 0; i < count; ++i) {
+        auto const wire = frame_relay_make_wire(i);
+        stream.insert(stream.end(), wire.begin(), wire.end());
+    }
+
+    flicker::frame_queue_t queue{};
+    std::atomic<bool> done{false};
+    std::size_t dropped = 0;
+    std::thread network([&] {
+        sky::mcp_deframer deframer{};
+        std::mt19937 rng{7};
+        std::uniform_int_distribution<std::size_t> chunk{1, 300};
+        for (std::size_t i = 0; i < stream.size();) {
+            auto const n = std::min(chunk(rng), stream.size() - i);
+            dropped += flicker::relay_frames(deframer, queue, stream.data() + i, n);
+            i += n;
+        }
+        done.store(true, std::memory_order_release);
+    });
+
+    // Frames come out in order, the ones the full queue dropped are skipped
+    std::size_t received = 0;
+    std::uint32_t next = 0;
+    bool in_order = true;
+    sky::mcp frame{};
+    while (true) {
+        auto const finished = done.load(std::memory_order_acquire);
+        while (queue.try_deq(frame)) {
+            sky::mcp_wire_t wire{};
+            flicker::encode_frame(wire, frame);
+            std::uint32_t index = 0;
+            std::memcpy(&index, frame.payload, sizeof(index));
+            in_order = in_order && index >= next && index < count
+                    && std::equal(wire, wire + sky::mcp_wire_size, stream.begin() + index * sky::mcp_wire_size);
+            next = index + 1;
+            ++received;
+        }
+        if (finished) break;
+    }
+    network.join();
+    EXPECT_TRUE(in_order);
+    EXPECT_EQ(received + dropped, count);
+}
+
+#endif  // !TESTS_FRAME_RELAY_TESTS_HPP
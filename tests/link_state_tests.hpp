@@ -0,0 +1,126 @@
+/**
+ * @file   link_state_tests.hpp
+ * @author Pratchaya Khansomboon (me@mononerv.dev)
+ * @brief  Versioned link-state table tests.
+ * @date   2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ */
+#ifndef TESTS_LINK_STATE_TESTS_HPP
+#define TESTS_LINK_STATE_TESTS_HPP
+
+#include <cstdint>
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "link_state.hpp"
+
+static auto link_state_make_advert(std::uint8_t origin, std::uint16_t version) -> sky::link_state_advert {
+    sky::link_state_advert advert{};
+    advert.origin[2] = origin;
+    advert.version = version;
+    advert.links[1][2] = static_cast<std::uint8_t>(origin + 1);
+    return advert;
+}
+
+TEST(sky_link_state, newer_wraps_around) {
+    EXPECT_TRUE(sky::link_state_newer(2, 1));
+    EXPECT_FALSE(sky::link_state_newer(1, 2));
+    EXPECT_FALSE(sky::link_state_newer(5, 5));
+    EXPECT_TRUE(sky::link_state_newer(1, 0));
+    EXPECT_FALSE(sky::link_state_newer(0, 1));
+    EXPECT_FALSE(sky::link_state_newer(0, 0));
+    EXPECT_TRUE(sky::link_state_newer(3, 0xFFF0));
+    EXPECT_FALSE(sky::link_state_newer(0xFFF0, 3));
+}
+
+TEST(sky_link_state, advert_payload) {
+    sky::link_state_advert advert{};
+    sky::address_t const origin{0x12, 0x34, 0x56};
+    std::memcpy(advert.origin, origin, sky::address_size);
+    advert.version = 0x1234;
+    advert.flags = sky::link_state_exit;
+    for (std::uint8_t i = 0; i < sky::link_state_links; ++i) advert.links[i][0] = static_cast<std::uint8_t>(i + 1);
+
+    sky::payload_t payload{};
+    sky::link_state_encode_advert(payload, advert);
+    EXPECT_EQ(payload[0], 0x34);
+    EXPECT_EQ(payload[1], 0x12);
+
+    auto const decoded = sky::link_state_decode_advert(origin, payload);
+    EXPECT_EQ(sky::mcp_address_to_u32(decoded.origin), sky::mcp_address_to_u32(origin));
+    EXPECT_EQ(decoded.version, 0x1234);
+    EXPECT_EQ(decoded.flags, sky::link_state_exit);
+    for (std::size_t i = 0; i < sky::link_state_links; ++i) {
+        EXPECT_EQ(std::memcmp(decoded.links[i], advert.links[i], sky::address_size), 0);
+    }
+}
+
+TEST(sky_link_state, digest_payload) {
+    sky::link_state_digest entries[2]{};
+    entries[0].origin[2] = 7;
+    entries[0].version = 3;
+    entries[1].origin[0] = 1;
+    entries[1].version = 0x0102;
+
+    sky::payload_t payload{};
+    sky::link_state_encode_digest(payload, entries, 2);
+    sky::link_state_digest decoded[sky::link_state_digests]{};
+    ASSERT_EQ(sky::link_state_decode_digest(payload, decoded), 2u);
+    EXPECT_EQ(decoded[0].origin[2], 7);
+    EXPECT_EQ(decoded[0].version, 3);
+    EXPECT_EQ(decoded[1].origin[0], 1);
+    EXPECT_EQ(decoded[1].version, 0x0102);
+}
+
+TEST(sky_link_state, apply_keeps_newest) {
+    sky::link_state_table<4> table{};
+    EXPECT_EQ(table.apply(link_state_make_advert(1, 0)), table.npos);  // Unknown is never stored
+    EXPECT_EQ(table.apply(link_state_make_advert(1, 2)), 0u);
+    EXPECT_EQ(table.apply(link_state_make_advert(2, 1)), 1u);
+    EXPECT_EQ(table.apply(link_state_make_advert(1, 2)), table.npos);
+    EXPECT_EQ(table.apply(link_state_make_advert(1, 1)), table.npos);
+
+    auto advert = link_state_make_advert(1, 3);
+    advert.links[1][2] = 9;
+    EXPECT_EQ(table.apply(advert), 0u);
+    sky::address_t const origin{0, 0, 1};
+    ASSERT_NE(table.find(origin), nullptr);
+    EXPECT_EQ(table.find(origin)->links[1][2], 9);
+    EXPECT_EQ(table.version(origin), 3);
+    sky::address_t const unknown{0, 0, 5};
+    EXPECT_EQ(table.find(unknown), nullptr);
+    EXPECT_EQ(table.version(unknown), 0);
+
+    EXPECT_EQ(table.size(), 2u);
+    EXPECT_EQ(table.stats().applied, 3u);
+    EXPECT_EQ(table.stats().stale, 2u);
+}
+
+TEST(sky_link_state, full_table) {
+    sky::link_state_table<2> table{};
+    EXPECT_EQ(table.apply(link_state_make_advert(1, 1)), 0u);
+    EXPECT_EQ(table.apply(link_state_make_advert(2, 1)), 1u);
+    EXPECT_EQ(table.apply(link_state_make_advert(3, 1)), table.npos);
+    EXPECT_EQ(table.stats().full, 1u);
+    // Origins already in still take updates
+    EXPECT_EQ(table.apply(link_state_make_advert(2, 2)), 1u);
+}
+
+TEST(sky_link_state, digest_rotates_through_table) {
+    sky::link_state_table<8> table{};
+    sky::link_state_digest entries[sky::link_state_digests]{};
+    EXPECT_EQ(table.next_digest(entries, sky::link_state_digests), 0u);
+
+    for (std::uint8_t i = 1; i <= 4; ++i) table.apply(link_state_make_advert(i, i));
+    ASSERT_EQ(table.next_digest(entries, sky::link_state_digests), 3u);
+    EXPECT_EQ(entries[0].origin[2], 1);
+    EXPECT_EQ(entries[2].origin[2], 3);
+    EXPECT_EQ(entries[2].version, 3);
+    ASSERT_EQ(table.next_digest(entries, sky::link_state_digests), 3u);
+    EXPECT_EQ(entries[0].origin[2], 4);
+    EXPECT_EQ(entries[1].origin[2], 1);
+    EXPECT_EQ(entries[2].origin[2], 2);
+}
+
+#endif  // !TESTS_LINK_STATE_TESTS_HPP
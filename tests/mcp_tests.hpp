@@ -9,7 +9,13 @@
  */
 #ifndef TESTS_MCP_TESTS_HPP
 #define TESTS_MCP_TESTS_HPP
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <vector>
+
 #include "mcp.hpp"
+#include "crc.hpp"
 #include "gtest/gtest.h"
 #include "fmt/format.h"
 
@@ -34,6 +40,7 @@ TEST(sky_mcp, make_buffer_from_mcp) {
         src.payload[i] = val++;
     }
     
+    src.sequence = 0;
     src.crc = 20;
 
     sky::mcp_buffer_t dest = {};
@@ -57,7 +64,7 @@ TEST(sky_mcp, make_mcp_from_buffer) {
     src[4] = 0x00;
     src[5] = 0x00;
     src[6] = 0x01;
-    src[22] = 1;
+    src[23] = 1;
 
     for (uint8_t i = 0; i < 15; i++) {
         src[i + 7] = 0x00;
@@ -67,6 +74,7 @@ TEST(sky_mcp, make_mcp_from_buffer) {
         {0x00, 0x04, 0x00},
         {0x00, 0x00, 0x01}, 
         {0x00},
+        0,
         1
     };
 
@@ -81,6 +89,7 @@ TEST(sky_mcp, make_mcp_from_buffer) {
     for (auto i = 0; i < 15; i++) {
         EXPECT_EQ(expected_mcp.payload[i], data.payload[i]);
     }
+    EXPECT_EQ(expected_mcp.sequence, data.sequence);
     EXPECT_EQ(expected_mcp.crc, data.crc);
 
 }
@@ -107,4 +116,123 @@ TEST(sky_mcp, convert_u32_to_address) {
    
 }
 
+TEST(sky_mcp, view_reads_fields_in_place) {
+    sky::mcp src{ 3, {0x01, 0x02, 0x03}, {0x04, 0x05, 0x06}, {7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21}, 0, 0 };
+    sky::mcp_buffer_t buffer{};
+    sky::mcp_make_buffer(buffer, src);
+
+    sky::mcp_view const view{buffer};
+    EXPECT_EQ(view.data(), buffer);
+    EXPECT_EQ(view.type(), 3);
+    EXPECT_EQ(sky::mcp_address_to_u32(view.source()), sky::mcp_address_to_u32(src.source));
+    EXPECT_EQ(sky::mcp_address_to_u32(view.destination()), sky::mcp_address_to_u32(src.destination));
+    EXPECT_EQ(&view.payload()[0], buffer + sky::mcp_payload_offset);
+    for (std::size_t i = 0; i < sky::payload_size; ++i)
+        EXPECT_EQ(view.payload()[i], src.payload[i]);
+    EXPECT_EQ(view.crc(), buffer[sky::mcp_buffer_size - 1]);
+    EXPECT_TRUE(view.check_crc());
+
+    auto const decoded = view.to_mcp();
+    auto const reference = sky::mcp_make_from_buffer(buffer);
+    EXPECT_EQ(std::memcmp(&decoded, &reference, sizeof(sky::mcp)), 0);
+}
+
+TEST(sky_mcp, mut_view_patches_destination) {
+    sky::mcp src{ 1, {0x01, 0x02, 0x03}, {0x04, 0x05, 0x06}, {1, 2, 3}, 0, 0 };
+    sky::mcp_buffer_t buffer{};
+    sky::mcp_make_buffer(buffer, src);
+
+    constexpr sky::address_t next = {0xAA, 0xBB, 0xCC};
+    sky::mcp_mut_view view{buffer};
+    view.set_destination(next);
+    view.set_payload(0, 0x01);
+
+    src.payload[0] = 0x01;
+    std::memcpy(src.destination, next, sky::address_size);
+    sky::mcp_buffer_t expected{};
+    sky::mcp_make_buffer(expected, src);
+    EXPECT_EQ(std::memcmp(buffer, expected, sky::mcp_buffer_size), 0);
+    EXPECT_TRUE(sky::mcp_check_crc(buffer));
+
+    buffer[sky::mcp_payload_offset + 4] ^= 0x10;
+    EXPECT_FALSE(sky::mcp_view{buffer}.check_crc());
+}
+
+TEST(sky_mcp, incremental_crc_matches_full_recompute) {
+    std::mt19937 rng{2022};
+    std::uniform_int_distribution<int> byte{0, 255};
+    std::uniform_int_distribution<std::size_t> offset{0, sky::mcp_crc_offset - 1};
+    for (auto n = 0; n < 1000; ++n) {
+        sky::mcp_buffer_t buffer{};
+        for (auto& b : buffer) b = static_cast<std::uint8_t>(byte(rng));
+        sky::mcp_mut_view view{buffer};
+        view.update_crc();
+
+        // Random field anywhere in the frame
+        auto const start = offset(rng);
+        auto const size  = std::min<std::size_t>(1 + offset(rng) % 4, sky::mcp_crc_offset - start);
+        std::uint8_t old_bytes[4]{};
+        std::memcpy(old_bytes, buffer + start, size);
+        for (std::size_t i = 0; i < size; ++i) buffer[start + i] = static_cast<std::uint8_t>(byte(rng));
+        auto updated = view.crc();
+        EXPECT_TRUE(sky::mcp_crc_update(updated, start, old_bytes, buffer + start, size));
+        EXPECT_EQ(updated, sky::crc_8(buffer, sky::mcp_crc_offset));
+
+        // Destination and payload setters
+        sky::address_t destination{};
+        for (auto& b : destination) b = static_cast<std::uint8_t>(byte(rng));
+        view.update_crc();
+        view.set_destination(destination);
+        EXPECT_TRUE(sky::mcp_check_crc(buffer));
+        view.set_payload(offset(rng) % sky::payload_size, static_cast<std::uint8_t>(byte(rng)));
+        EXPECT_TRUE(sky::mcp_check_crc(buffer));
+    }
+}
+
+TEST(sky_mcp, incremental_crc_rejects_fields_past_the_crc) {
+    std::uint8_t const old_bytes[4]{1, 2, 3, 4};
+    std::uint8_t const new_bytes[4]{5, 6, 7, 8};
+    std::uint8_t crc = 0x5A;
+    // The crc byte itself, a field running into it and an offset that would wrap around
+    EXPECT_FALSE(sky::mcp_crc_update(crc, sky::mcp_crc_offset, old_bytes, new_bytes, 1));
+    EXPECT_FALSE(sky::mcp_crc_update(crc, sky::mcp_crc_offset - 2, old_bytes, new_bytes, 4));
+    EXPECT_FALSE(sky::mcp_crc_update(crc, 1, old_bytes, new_bytes, SIZE_MAX));
+    EXPECT_EQ(crc, 0x5A);
+    EXPECT_TRUE(sky::mcp_crc_update(crc, sky::mcp_crc_offset - 4, old_bytes, new_bytes, 4));
+}
+
+TEST(sky_mcp, batch_matches_single_frame_functions) {
+    std::mt19937 rng{23};
+    std::uniform_int_distribution<int> byte{0, 255};
+    constexpr std::size_t count = 77;  // Not a multiple of the block size
+
+    std::vector<sky::mcp> frames(count);
+    for (auto& frame : frames) {
+        auto* raw = reinterpret_cast<std::uint8_t*>(&frame);
+        for (std::size_t i = 0; i < sizeof(sky::mcp); ++i) raw[i] = static_cast<std::uint8_t>(byte(rng));
+    }
+
+    std::vector<sky::mcp_buffer_t> encoded(count);
+    sky::mcp_encode_batch(encoded.data(), frames.data(), count);
+    for (std::size_t i = 0; i < count; ++i) {
+        sky::mcp_buffer_t expected{};
+        sky::mcp_make_buffer(expected, frames[i]);
+        EXPECT_EQ(std::memcmp(expected, encoded[i], sky::mcp_buffer_size), 0) << "frame: " << i;
+    }
+
+    // Corrupt every third frame
+    for (std::size_t i = 0; i < count; i += 3) encoded[i][5] ^= 0x01;
+
+    std::vector<std::uint32_t> valid(sky::mcp_batch_mask_words(count));
+    std::vector<sky::mcp> decoded(count);
+    auto const valid_count = sky::mcp_decode_batch(decoded.data(), encoded.data(), count, valid.data());
+    EXPECT_EQ(valid_count, count - (count + 2) / 3);
+    for (std::size_t i = 0; i < count; ++i) {
+        auto const bit = (valid[i / sky::mcp_batch_lanes] >> (i % sky::mcp_batch_lanes)) & 1;
+        EXPECT_EQ(bit == 1, sky::mcp_check_crc(encoded[i])) << "frame: " << i;
+        auto const reference = sky::mcp_make_from_buffer(encoded[i]);
+        EXPECT_EQ(std::memcmp(&reference, &decoded[i], sizeof(sky::mcp)), 0) << "frame: " << i;
+    }
+}
+
 #endif  // !TESTS_MCP_TESTS_HPP
@@ -0,0 +1,283 @@
+/**
+ * @file   mesh_tests.hpp
+ * @author Pratchaya Khansomboon (me@mononerv.dev)
+ * @brief  Discrete-event mesh simulator tests.
+ * @date   2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ */
+#ifndef TESTS_MESH_TESTS_HPP
+#define TESTS_MESH_TESTS_HPP
+
+#include "gtest/gtest.h"
+#include "mesh.hpp"
+
+TEST(sunlight_mesh, grid_discovers_and_spreads_fire) {
+    auto sim = ray::make_grid_mesh(3, 3);
+    sim->set_exit(8);
+    sim->set_fire(0, 50'000'000);
+    sim->run_until(49'000'000);
+
+    // Frames are lost whenever the other end listens on another channel, the mesh gets
+    // there eventually but not every edge and address is guaranteed in a given time
+    auto report = sim->report();
+    for (std::size_t i = 0; i < sim->size(); ++i) {
+        bool verified = false;
+        for (std::size_t ch = 0; ch < ray::MAX_CHANNEL; ++ch) verified = verified || sim->at(i).is_edge_verified(ch);
+        EXPECT_TRUE(verified) << "node " << i;
+        EXPECT_EQ(sim->at(i).state(), ray::node_state::idle) << "node " << i;
+        EXPECT_GE(sim->at(i).addresses().size(), 2u) << "node " << i;
+    }
+    EXPECT_GT(report.topology_us, 0);
+    EXPECT_GT(report.exits_us, 0);
+    EXPECT_EQ(report.fire_us, -1);
+    EXPECT_EQ(report.fire_nodes, 0u);
+
+    sim->run_until(60'000'000);
+    report = sim->report();
+    EXPECT_EQ(report.fire_us, 50'000'000);
+    EXPECT_GE(report.fire_nodes, 2u);
+    EXPECT_GT(report.fire_spread_us, 0);
+    EXPECT_EQ(sim->at(0).state(), ray::node_state::fire);
+    EXPECT_GT(report.frames, 0u);
+    EXPECT_GT(report.packets_sent, report.frames);
+    EXPECT_EQ(report.now_us, 60'000'000u);
+}
+
+TEST(sunlight_mesh, same_seed_same_run) {
+    ray::mesh_config config{};
+    config.seed = 42;
+    auto a = ray::make_grid_mesh(4, 2, config);
+    auto b = ray::make_grid_mesh(4, 2, config);
+    a->run_until(40'000'000);
+    b->run_until(40'000'000);
+    auto const x = a->report();
+    auto const y = b->report();
+    EXPECT_EQ(x.events, y.events);
+    EXPECT_EQ(x.packets_sent, y.packets_sent);
+    EXPECT_EQ(x.bytes_lost, y.bytes_lost);
+    EXPECT_EQ(x.frames, y.frames);
+    EXPECT_EQ(x.edges_verified_us, y.edges_verified_us);
+
+    config.seed = 43;
+    auto c = ray::make_grid_mesh(4, 2, config);
+    c->run_until(40'000'000);
+    EXPECT_NE(c->report().packets_sent, x.packets_sent);
+}
+
+TEST(sunlight_mesh, same_run_on_any_thread_count) {
+    auto run = [](std::size_t threads, ray::mesh_config config) {
+        config.seed = 7;
+        config.threads = threads;
+        auto sim = ray::make_grid_mesh(5, 4, config);
+        sim->set_exit(19);
+        sim->set_fire(6, 30'000'000);
+        sim->run_until(20'000'000);
+        sim->run_until(35'000'000);
+        return sim;
+    };
+    ray::mesh_config configs[3]{};
+    configs[1].schedule = ray::mesh_schedule::adaptive;
+    configs[2].schedule = ray::mesh_schedule::adaptive;
+    configs[2].burst_us = 100'000;
+    configs[2].coalesce = true;
+    configs[2].priority = true;
+    for (auto const& config : configs) {
+        auto const base = run(1, config);
+        auto const expected = base->report();
+        for (std::size_t threads : {2u, 3u, 4u, 32u}) {
+            auto const sim = run(threads, config);
+            auto const report = sim->report();
+            EXPECT_EQ(report.events, expected.events) << threads << " threads";
+            EXPECT_EQ(report.packets_sent, expected.packets_sent) << threads << " threads";
+            EXPECT_EQ(report.send_slots, expected.send_slots) << threads << " threads";
+            EXPECT_EQ(report.mean_drain_us, expected.mean_drain_us) << threads << " threads";
+            EXPECT_EQ(report.suppressed, expected.suppressed) << threads << " threads";
+            EXPECT_EQ(report.evicted, expected.evicted) << threads << " threads";
+            EXPECT_EQ(report.bytes_lost, expected.bytes_lost) << threads << " threads";
+            EXPECT_EQ(report.frames, expected.frames) << threads << " threads";
+            EXPECT_EQ(report.edges_verified_us, expected.edges_verified_us) << threads << " threads";
+            EXPECT_EQ(report.topology_us, expected.topology_us) << threads << " threads";
+            EXPECT_EQ(report.exits_us, expected.exits_us) << threads << " threads";
+            EXPECT_EQ(report.fire_spread_us, expected.fire_spread_us) << threads << " threads";
+            EXPECT_EQ(report.fire_nodes, expected.fire_nodes) << threads << " threads";
+            EXPECT_GE(report.windows, expected.windows) << threads << " threads";
+            for (std::size_t i = 0; i < sim->size(); ++i) {
+                EXPECT_EQ(sim->at(i).state(), base->at(i).state()) << "node " << i;
+                EXPECT_EQ(sim->at(i).addresses().size(), base->at(i).addresses().size()) << "node " << i;
+                EXPECT_EQ(sim->at(i).frames_received(), base->at(i).frames_received()) << "node " << i;
+            }
+        }
+    }
+}
+
+TEST(sunlight_mesh, no_fire_without_a_fire_switch) {
+    // Every byte after a cut frame starts a shifted window and none of them may pass as a frame.
+    // With only the CRC-8 a few did, and one fire frame out of noise took most of the grid down.
+    ray::mesh_config configs[2]{};
+    configs[1].schedule = ray::mesh_schedule::adaptive;
+    configs[1].burst_us = 100'000;
+    configs[1].coalesce = true;
+    configs[1].priority = true;
+    for (auto const& base : configs) {
+        for (uint64_t seed = 1; seed <= 16; ++seed) {
+            auto config = base;
+            config.seed = seed;
+            auto sim = ray::make_grid_mesh(5, 5, config);
+            sim->set_exit(12);
+            sim->run_until(120'000'000);
+            EXPECT_EQ(sim->report().fire_nodes, 0u) << "seed " << seed << ", burst " << config.burst_us;
+        }
+    }
+    // The long chain floods the most frames through every node
+    ray::mesh_config config = configs[1];
+    config.threads = 4;
+    for (uint64_t seed = 1; seed <= 4; ++seed) {
+        config.seed = seed;
+        auto sim = ray::make_grid_mesh(101, 1, config);
+        sim->set_exit(100);
+        sim->run_until(245'000'000);
+        EXPECT_EQ(sim->report().fire_nodes, 0u) << "chain seed " << seed;
+    }
+}
+
+TEST(sunlight_mesh, burst_drains_queues_faster) {
+    uint64_t single_frames = 0;
+    uint64_t burst_frames  = 0;
+    for (uint64_t seed = 1; seed <= 6; ++seed) {
+        ray::mesh_config config{};
+        config.seed = seed;
+        config.schedule = ray::mesh_schedule::adaptive;
+        auto single = ray::make_grid_mesh(5, 5, config);
+        config.burst_us = 100'000;
+        auto burst = ray::make_grid_mesh(5, 5, config);
+        single->set_exit(12);
+        burst->set_exit(12);
+        single->run_until(20'000'000);
+        burst->run_until(20'000'000);
+
+        auto const one = single->report();
+        auto const many = burst->report();
+        EXPECT_EQ(one.fire_nodes + many.fire_nodes, 0u) << "seed " << seed;
+        EXPECT_EQ(one.packets_sent, one.send_slots) << "seed " << seed;
+        EXPECT_GT(many.packets_sent, 2 * many.send_slots) << "seed " << seed;
+        ASSERT_GT(one.mean_drain_us, 0) << "seed " << seed;
+        ASSERT_GT(many.mean_drain_us, 0) << "seed " << seed;
+        EXPECT_LT(many.mean_drain_us, one.mean_drain_us) << "seed " << seed;
+        // A burst is split into packets on the way in and the frames are found again. How many
+        // frames a run gets through moves with the seed, more of them over the whole range
+        EXPECT_GT(5 * many.frames, 4 * one.frames) << "seed " << seed;
+        EXPECT_GT(many.exit_reached_us, 0) << "seed " << seed;
+        single_frames += one.frames;
+        burst_frames  += many.frames;
+    }
+    EXPECT_GT(burst_frames, single_frames);
+}
+
+TEST(sunlight_mesh, priority_speeds_fire_down_a_chain) {
+    // 100 hops with the board's link settings, the idle beacons and their 16 copy floods
+    // keep every out queue full. Returns how long until a fire frame from the burning light
+    // put the far end in fire mode.
+    auto fire_latency = [](bool priority, uint64_t seed, uint64_t limit_us) -> uint64_t {
+        ray::mesh_config config{};
+        config.seed = seed;
+        config.schedule = ray::mesh_schedule::adaptive;
+        config.burst_us = 100'000;
+        config.coalesce = true;
+        config.priority = priority;
+        auto sim = ray::make_grid_mesh(101, 1, config);
+        sim->set_exit(100);
+        // The fire switch is read once the config phase is over
+        sim->run_until(45'000'000);
+        EXPECT_EQ(sim->report().fire_nodes, 0u) << "seed " << seed;
+        sim->set_fire(0, 45'000'000);
+        auto const origin = sky::mcp_address_to_u32(sim->at(0).address());
+        auto const reached = [&sim, origin] {
+            return sim->at(100).state() == ray::node_state::fire && sky::mcp_address_to_u32(sim->at(100).fire_source()) == origin;
+        };
+        auto now = sim->now();
+        while (now - 45'000'000 < limit_us && !reached()) {
+            now += 500'000;
+            sim->run_until(now);
+        }
+        // Every light that burns got there from the one fire
+        for (std::size_t i = 0; i < sim->size(); ++i) {
+            if (sim->at(i).state() != ray::node_state::fire) continue;
+            EXPECT_EQ(sky::mcp_address_to_u32(sim->at(i).fire_source()), origin) << "seed " << seed << ", node " << i;
+        }
+        return now - 45'000'000;
+    };
+
+    for (uint64_t seed = 1; seed <= 3; ++seed) {
+        auto const prioritised = fire_latency(true, seed, 120'000'000);
+        ASSERT_LT(prioritised, 120'000'000u) << "seed " << seed;
+        auto const fifo = fire_latency(false, seed, 2 * prioritised);
+        EXPECT_GE(fifo, 2 * prioritised) << "seed " << seed;
+    }
+}
+
+TEST(sunlight_mesh, link_state_gossip_converges_with_fewer_frames) {
+    // Board link settings on every seed of a range, none of them may set a light on fire
+    auto run = [](bool link_state, uint64_t seed) {
+        ray::mesh_config config{};
+        config.seed = seed;
+        config.schedule = ray::mesh_schedule::adaptive;
+        config.burst_us = 100'000;
+        config.coalesce = true;
+        config.priority = true;
+        config.link_state = link_state;
+        auto sim = ray::make_grid_mesh(4, 4, config);
+        sim->set_exit(0);
+        sim->run_until(90'000'000);
+        return sim;
+    };
+    uint64_t flood_writes  = 0;
+    uint64_t gossip_writes = 0;
+    for (uint64_t seed = 1; seed <= 6; ++seed) {
+        auto const flood = run(false, seed);
+        auto const gossip = run(true, seed);
+        EXPECT_EQ(flood->report().fire_nodes + gossip->report().fire_nodes, 0u) << "seed " << seed;
+
+        // The adverts go out during the config phase already, the floods only once it is over
+        EXPECT_GT(gossip->topology_coverage(), 0.99) << "seed " << seed;
+        EXPECT_LT(flood->topology_coverage(), gossip->topology_coverage()) << "seed " << seed;
+        EXPECT_GT(gossip->report().exit_reached_us, 0) << "seed " << seed;
+        // About 8x fewer on this grid, leave room for the seed
+        EXPECT_LT(4 * gossip->report().topology_writes, flood->report().topology_writes) << "seed " << seed;
+        flood_writes  += flood->report().topology_writes;
+        gossip_writes += gossip->report().topology_writes;
+    }
+    RecordProperty("flood_topology_writes", static_cast<int>(flood_writes));
+    RecordProperty("gossip_topology_writes", static_cast<int>(gossip_writes));
+}
+
+TEST(sunlight_mesh, discovery_converges_past_the_board_capacity) {
+    // 36 lights, more than a board node holds, every one of them learns the whole grid
+    ray::mesh_config config{};
+    config.schedule = ray::mesh_schedule::adaptive;
+    config.burst_us = 100'000;
+    config.coalesce = true;
+    config.priority = true;
+    config.link_state = true;
+    auto sim = ray::make_grid_mesh(6, 6, config);
+    sim->set_exit(0);
+    sim->run_until(120'000'000);
+    EXPECT_GT(sim->size(), ray::node::max_nodes);
+    EXPECT_DOUBLE_EQ(sim->topology_coverage(), 1.0);
+    for (std::size_t i = 0; i < sim->size(); ++i) EXPECT_EQ(sim->at(i).addresses().size(), sim->size()) << "node " << i;
+}
+
+TEST(sunlight_mesh, unwired_channel_is_lost) {
+    ray::mesh sim{2};
+    EXPECT_TRUE(sim.connect(0, 1, 1, 3));
+    EXPECT_FALSE(sim.connect(0, 1, 1, 2));
+    EXPECT_FALSE(sim.connect(0, 0, 0, 2));
+    sim.run_until(40'000'000);
+    EXPECT_TRUE(sim.at(0).is_edge_verified(1));
+    EXPECT_TRUE(sim.at(1).is_edge_verified(3));
+    EXPECT_FALSE(sim.at(0).is_edge_verified(0));
+    EXPECT_GE(sim.report().edges_verified_us, 0);
+    EXPECT_GT(sim.report().bytes_lost, 0u);
+}
+
+#endif  // !TESTS_MESH_TESTS_HPP
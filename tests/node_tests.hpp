@@ -0,0 +1,331 @@
+/**
+ * @file   node_tests.hpp
+ * @author Pratchaya Khansomboon (me@mononerv.dev)
+ * @brief  sunlight node logic on a host hal.
+ * @date   2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ */
+#ifndef TESTS_NODE_TESTS_HPP
+#define TESTS_NODE_TESTS_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <memory>
+
+#include "gtest/gtest.h"
+#include "node.hpp"
+
+namespace node_test {
+struct fake_clock : ray::clock {
+    std::uint32_t now = 0;
+    auto millis() const -> std::uint32_t override { return now; }
+};
+
+struct fake_chip : ray::chip {
+    std::uint32_t value = 0;
+    auto id() const -> std::uint32_t override { return value; }
+};
+
+struct fake_leds : ray::leds {
+    std::uint32_t pixels[ray::MAX_CHANNEL]{};
+    auto set_pixel(std::size_t index, std::uint32_t color) -> void override { pixels[index] = color; }
+    auto show() -> void override {}
+};
+
+struct fake_pins : ray::config_pins {
+    bool reset = false;
+    bool fire  = false;
+    bool exit  = false;
+    auto is_reset() const -> bool override { return reset; }
+    auto is_fire() const -> bool override { return fire; }
+    auto is_exit() const -> bool override { return exit; }
+};
+
+// Every channel is wired straight to a channel of another node, nothing is lost.
+struct fake_channels : ray::channels {
+    fake_channels* peer[ray::MAX_CHANNEL]{};
+    std::uint8_t peer_channel[ray::MAX_CHANNEL]{};
+    std::deque<ray::packet> in[ray::MAX_CHANNEL]{};
+    std::uint32_t writes[8]{};  // By frame type
+    bool drop_adverts = false;
+
+    auto poll() -> void override {}
+    auto write(ray::packet const& pkt) noexcept -> void override {
+        auto const type = pkt.data[0] & 7u;
+        ++writes[type];
+        if (drop_adverts && type == 6) return;
+        if (pkt.channel >= ray::MAX_CHANNEL || peer[pkt.channel] == nullptr) return;
+        auto copy = pkt;
+        copy.channel = peer_channel[pkt.channel];
+        peer[pkt.channel]->in[copy.channel].push_back(copy);
+    }
+    auto read(std::uint8_t channel) noexcept -> ray::packet override {
+        if (in[channel].empty()) return {};
+        auto const pkt = in[channel].front();
+        in[channel].pop_front();
+        return pkt;
+    }
+    auto clear_buffer(std::uint8_t channel) noexcept -> void override { in[channel].clear(); }
+    auto overwritten(std::uint8_t) const noexcept -> std::size_t override { return 0; }
+};
+
+struct light {
+    fake_chip chip;
+    fake_channels com;
+    fake_leds leds;
+    fake_pins pins;
+    ray::node node;
+
+    light(fake_clock& clock, std::uint32_t address)
+        : chip(make_chip(address)), com(), leds(), pins(), node({clock, chip, com, leds, pins, nullptr}) {}
+
+    static auto make_chip(std::uint32_t address) -> fake_chip {
+        fake_chip result{};
+        result.value = address;
+        return result;
+    }
+};
+
+inline auto connect(light& a, std::uint8_t a_channel, light& b, std::uint8_t b_channel) -> void {
+    a.com.peer[a_channel] = &b.com;
+    a.com.peer_channel[a_channel] = b_channel;
+    b.com.peer[b_channel] = &a.com;
+    b.com.peer_channel[b_channel] = a_channel;
+}
+
+// Three lights in a row, the last one is an exit.
+struct corridor {
+    fake_clock clock{};
+    std::unique_ptr<light> lights[3]{
+        std::make_unique<light>(clock, 0x0000A1),
+        std::make_unique<light>(clock, 0x0000B2),
+        std::make_unique<light>(clock, 0x0000C3),
+    };
+
+    explicit corridor(bool link_state = false) {
+        connect(*lights[0], 1, *lights[1], 3);
+        connect(*lights[1], 1, *lights[2], 3);
+        lights[2]->pins.exit = true;
+        for (auto& l : lights) {
+            l->node.set_link_state(link_state);
+            l->node.setup();
+        }
+    }
+
+    auto run(std::uint32_t millis) -> void {
+        for (std::uint32_t end = clock.now + millis; clock.now < end; clock.now += 5) {
+            for (auto& l : lights) l->node.loop();
+        }
+    }
+};
+} // namespace node_test
+
+TEST(sunlight_node, discovers_edges) {
+    using namespace node_test;
+    auto mesh = std::make_unique<corridor>();
+    auto& lights = mesh->lights;
+    mesh->run(40'000);
+
+    for (auto& l : lights) EXPECT_EQ(l->node.state(), ray::node_state::idle);
+    EXPECT_TRUE(lights[0]->node.is_edge_verified(1));
+    EXPECT_FALSE(lights[0]->node.is_edge_verified(0));
+    EXPECT_TRUE(lights[1]->node.is_edge_verified(1));
+    EXPECT_TRUE(lights[1]->node.is_edge_verified(3));
+    EXPECT_EQ(sky::mcp_address_to_u32(lights[0]->node.edge(1)), 0x0000B2u);
+    EXPECT_EQ(sky::mcp_address_to_u32(lights[2]->node.edge(3)), 0x0000B2u);
+    EXPECT_EQ(lights[0]->leds.pixels[1], 0x00FF00u);
+}
+
+TEST(sunlight_node, routes_to_exit_on_fire) {
+    using namespace node_test;
+    auto mesh = std::make_unique<corridor>();
+    auto& lights = mesh->lights;
+    mesh->run(45'000);
+
+    // Every light heard of the others and of the exit through the flooded frames
+    for (auto& l : lights) {
+        EXPECT_EQ(l->node.addresses().size(), 3u);
+        EXPECT_EQ(l->node.exit_count(), 1u);
+    }
+
+    lights[0]->pins.fire = true;
+    mesh->run(1'000);
+    EXPECT_EQ(lights[0]->node.state(), ray::node_state::fire);
+    EXPECT_EQ(lights[1]->node.state(), ray::node_state::fire);
+    EXPECT_EQ(sky::mcp_address_to_u32(lights[0]->node.fire_source()), 0x0000A1u);
+    EXPECT_EQ(sky::mcp_address_to_u32(lights[1]->node.fire_source()), 0x0000A1u);
+
+    // Longest way out is from the first light, through the middle to the exit
+    auto const& path = lights[0]->node.shortest_path();
+    auto const& addresses = lights[0]->node.addresses();
+    ASSERT_NE(path[0], 0);
+    ASSERT_NE(path[2], 0);
+    EXPECT_EQ(path[3], 0);
+    EXPECT_EQ(sky::mcp_address_to_u32(addresses[path[0] - 1u]), 0x0000A1u);
+    EXPECT_EQ(sky::mcp_address_to_u32(addresses[path[1] - 1u]), 0x0000B2u);
+    EXPECT_EQ(sky::mcp_address_to_u32(addresses[path[2] - 1u]), 0x0000C3u);
+}
+
+TEST(sunlight_node, reset_is_forwarded_as_sent) {
+    using namespace node_test;
+    auto mesh = std::make_unique<corridor>();
+    auto& lights = mesh->lights;
+    mesh->run(45'000);
+    lights[2]->com.in[3].clear();
+    lights[0]->com.in[1].clear();
+
+    // A reset from the first light reaches the middle one
+    sky::mcp reset{};
+    reset.type = 4;
+    sky::mcp_u32_to_address(reset.source, 0x0000A1);
+    sky::mcp_u32_to_address(reset.destination, 0x0000B2);
+    reset.sequence = 200;
+    sky::mcp_buffer_t frame{};
+    sky::mcp_make_buffer(frame, reset);
+    ray::packet pkt{};
+    pkt.channel = 3;
+    pkt.size = static_cast<std::uint8_t>(sky::mcp_wire_size);
+    sky::mcp_make_wire(reinterpret_cast<sky::mcp_wire_t&>(pkt.data), frame);
+    lights[1]->com.in[3].push_back(pkt);
+    lights[1]->node.loop();
+
+    // Passed on with its own source and sequence, acknowledged back to the sender
+    auto resets = [](std::deque<ray::packet> const& in, std::uint8_t ack) {
+        std::size_t count = 0;
+        for (auto const& p : in) {
+            sky::mcp_view const view{p.data};
+            if (view.type() != 4 || view.payload()[0] != ack) continue;
+            EXPECT_EQ(sky::mcp_address_to_u32(view.source()), 0x0000A1u);
+            EXPECT_EQ(view.sequence(), 200);
+            ++count;
+        }
+        return count;
+    };
+    EXPECT_GT(resets(lights[2]->com.in[3], 0), 0u);
+    EXPECT_GT(resets(lights[0]->com.in[1], 1), 0u);
+
+    // A copy of the same reset is a duplicate and goes no further
+    lights[2]->com.in[3].clear();
+    lights[1]->com.in[3].push_back(pkt);
+    lights[1]->node.loop();
+    EXPECT_EQ(resets(lights[2]->com.in[3], 0), 0u);
+}
+
+TEST(sunlight_node, link_state_routes_to_exit_on_fire) {
+    using namespace node_test;
+    auto mesh = std::make_unique<corridor>(true);
+    auto& lights = mesh->lights;
+    mesh->run(45'000);
+
+    // Topology and exit came with the adverts, nothing was flooded
+    for (auto& l : lights) {
+        EXPECT_EQ(l->node.addresses().size(), 3u);
+        EXPECT_EQ(l->node.exit_count(), 1u);
+        EXPECT_EQ(l->com.writes[1], 0u);
+        EXPECT_EQ(l->com.writes[5], 0u);
+    }
+
+    lights[0]->pins.fire = true;
+    mesh->run(1'000);
+    EXPECT_EQ(lights[1]->node.state(), ray::node_state::fire);
+    auto const& path = lights[0]->node.shortest_path();
+    auto const& addresses = lights[0]->node.addresses();
+    ASSERT_NE(path[2], 0);
+    EXPECT_EQ(path[3], 0);
+    EXPECT_EQ(sky::mcp_address_to_u32(addresses[path[1] - 1u]), 0x0000B2u);
+    EXPECT_EQ(sky::mcp_address_to_u32(addresses[path[2] - 1u]), 0x0000C3u);
+}
+
+TEST(sunlight_node, link_state_adverts_only_on_change) {
+    using namespace node_test;
+    auto mesh = std::make_unique<corridor>(true);
+    auto& lights = mesh->lights;
+    mesh->run(45'000);
+
+    auto count = [&lights](std::uint8_t type) {
+        std::uint32_t total = 0;
+        for (auto& l : lights) total += l->com.writes[type];
+        return total;
+    };
+    auto const adverts = count(6);
+    auto const digests = count(7);
+    mesh->run(20'000);
+
+    // Nothing changed, only the digests go on, one per channel every 2 s
+    EXPECT_EQ(count(6), adverts);
+    EXPECT_GT(count(7), digests);
+    EXPECT_LE(count(7) - digests, 4u * ray::node::gossip_copies * 11u);
+}
+
+TEST(sunlight_node, link_state_digest_catches_up) {
+    using namespace node_test;
+    auto mesh = std::make_unique<corridor>(true);
+    auto& lights = mesh->lights;
+    // The middle light's adverts and forwards are all lost, the ends only know themselves
+    lights[1]->com.drop_adverts = true;
+    mesh->run(45'000);
+    EXPECT_EQ(lights[0]->node.exit_count(), 0u);
+    EXPECT_LT(lights[0]->node.addresses().size(), 3u);
+
+    // The ends ask for what the middle's digests list and get the adverts
+    lights[1]->com.drop_adverts = false;
+    mesh->run(30'000);
+    for (auto& l : lights) {
+        EXPECT_EQ(l->node.addresses().size(), 3u);
+        EXPECT_EQ(l->node.exit_count(), 1u);
+    }
+}
+
+namespace node_test {
+// Topology frames of a row of count lights, 0x100 + i next to 0x100 + i - 1 and 0x100 + i + 1
+template <typename Node>
+auto learn_row(Node& light, std::uint32_t count) -> void {
+    for (std::uint32_t i = 0; i < count; ++i) {
+        sky::mcp frame{ 1, {}, {}, {}, 0, 0 };
+        sky::address_t left{};
+        sky::address_t right{};
+        sky::mcp_u32_to_address(frame.source, 0x100 + i);
+        if (i > 0) sky::mcp_u32_to_address(left, 0x100 + i - 1);
+        if (i + 1 < count) sky::mcp_u32_to_address(right, 0x100 + i + 1);
+        std::memcpy(frame.payload, frame.source, sky::address_size);
+        std::memcpy(frame.payload + 3, left, sky::address_size);
+        std::memcpy(frame.payload + 6, right, sky::address_size);
+
+        sky::mcp_buffer_t buffer{};
+        sky::mcp_make_buffer(buffer, frame);
+        ray::packet pkt{};
+        pkt.size = static_cast<std::uint8_t>(sky::mcp_buffer_size);
+        std::memcpy(pkt.data, buffer, sky::mcp_buffer_size);
+        light.handle_message(pkt);
+    }
+}
+} // namespace node_test
+
+TEST(sunlight_node, host_node_holds_a_grid) {
+    using namespace node_test;
+    fake_clock clock{};
+    fake_chip chip = light::make_chip(0x0000A1);
+    fake_channels com{};
+    fake_leds leds{};
+    fake_pins pins{};
+    auto board = std::make_unique<ray::node>(ray::hal{clock, chip, com, leds, pins, nullptr});
+    auto host  = std::make_unique<ray::host_node>(ray::hal{clock, chip, com, leds, pins, nullptr});
+    board->setup();
+    host->setup();
+    learn_row(*board, 100);
+    learn_row(*host, 100);
+
+    // Itself and the first lights heard of, the rest does not fit the board's topology
+    EXPECT_EQ(board->addresses().size(), ray::node::max_nodes);
+    EXPECT_EQ(host->addresses().size(), 101u);
+    auto const a = host->addresses().find(0x100 + 90);
+    auto const b = host->addresses().find(0x100 + 91);
+    ASSERT_NE(a, host->addresses().npos);
+    ASSERT_NE(b, host->addresses().npos);
+    EXPECT_EQ(host->topology().matrix[a][b], 1);
+    EXPECT_EQ(host->topology().matrix[b][a], 1);
+}
+
+#endif  // !TESTS_NODE_TESTS_HPP
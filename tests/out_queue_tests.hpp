@@ -0,0 +1,106 @@
+/**
+ * @file   out_queue_tests.hpp
+ * @author Pratchaya Khansomboon (me@mononerv.dev)
+ * @brief  multicom out queue tests.
+ * @date   2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ */
+#ifndef TESTS_OUT_QUEUE_TESTS_HPP
+#define TESTS_OUT_QUEUE_TESTS_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#include "gtest/gtest.h"
+#include "mcp.hpp"
+#include "out_queue.hpp"
+
+static auto out_queue_make_packet(uint8_t value) -> ray::packet {
+    ray::packet pkt{};
+    pkt.size = static_cast<uint8_t>(sky::mcp_wire_size);
+    for (std::size_t i = 0; i < pkt.size; ++i) pkt.data[i] = static_cast<uint8_t>(value + i);
+    return pkt;
+}
+
+TEST(sunlight_out_queue, floods_evict_without_coalescing) {
+    ray::out_queue queue{};
+    queue.push(out_queue_make_packet(1));
+    for (std::size_t i = 0; i < ray::MAX_QUEUE; ++i) queue.push(out_queue_make_packet(2));
+    EXPECT_EQ(queue.size(), ray::MAX_QUEUE);
+    EXPECT_EQ(queue.evicted(), 1u);
+    EXPECT_EQ(queue.suppressed(), 0u);
+    EXPECT_EQ(queue.front().data[0], 2);
+}
+
+TEST(sunlight_out_queue, coalesced_copies_take_turns) {
+    ray::out_queue queue{};
+    queue.set_coalesce(true);
+    queue.push(out_queue_make_packet(1));
+    for (std::size_t i = 0; i < 3; ++i) queue.push(out_queue_make_packet(2));
+    queue.push(out_queue_make_packet(3));
+    queue.push(out_queue_make_packet(1));
+    EXPECT_EQ(queue.size(), 3u);
+    EXPECT_EQ(queue.suppressed(), 3u);
+
+    // Every pop sends one copy, a packet with copies left goes behind the others
+    uint8_t const expected[] = {1, 2, 3, 1, 2, 2};
+    for (auto const value : expected) {
+        ASSERT_FALSE(queue.empty());
+        EXPECT_EQ(queue.front().data[0], value);
+        queue.pop();
+    }
+    EXPECT_TRUE(queue.empty());
+    EXPECT_EQ(queue.evicted(), 0u);
+}
+
+TEST(sunlight_out_queue, copies_are_capped) {
+    ray::out_queue queue{};
+    queue.set_coalesce(true);
+    for (std::size_t i = 0; i < 100; ++i) queue.push(out_queue_make_packet(7));
+    EXPECT_EQ(queue.size(), 1u);
+    EXPECT_EQ(queue.suppressed(), 99u);
+    std::size_t sent = 0;
+    for (; !queue.empty(); queue.pop()) ++sent;
+    EXPECT_EQ(sent, ray::out_queue::max_copies);
+
+    // A packet that differs in one byte is not a copy
+    auto other = out_queue_make_packet(7);
+    other.data[5] ^= 1;
+    queue.push(out_queue_make_packet(7));
+    queue.push(other);
+    EXPECT_EQ(queue.size(), 2u);
+}
+
+TEST(sunlight_out_queue, fire_and_reset_go_first) {
+    auto frame = [](uint8_t type, uint8_t value) {
+        auto pkt = out_queue_make_packet(value);
+        pkt.data[0] = type;
+        return pkt;
+    };
+    EXPECT_TRUE(ray::out_queue::is_urgent(frame(3, 0)));
+    EXPECT_TRUE(ray::out_queue::is_urgent(frame(4, 0)));
+    EXPECT_FALSE(ray::out_queue::is_urgent(frame(1, 0)));
+
+    ray::out_queue fifo{};
+    fifo.push(frame(1, 10));
+    fifo.push(frame(3, 20));
+    EXPECT_EQ(fifo.front().data[1], 11);
+
+    ray::out_queue queue{};
+    queue.set_priority(true);
+    for (uint8_t i = 0; i < 3; ++i) queue.push(frame(1, static_cast<uint8_t>(10 + i)));
+    for (uint8_t i = 0; i < 6; ++i) queue.push(frame(3, static_cast<uint8_t>(20 + i)));
+    EXPECT_EQ(queue.size(), 9u);
+
+    // urgent_run fire frames, then a beacon gets its turn, the rest in the same way
+    uint8_t const expected[] = {20, 21, 22, 23, 10, 24, 25, 11, 12};
+    for (auto const value : expected) {
+        ASSERT_FALSE(queue.empty());
+        EXPECT_EQ(queue.front().data[1], value + 1);
+        queue.pop();
+    }
+    EXPECT_TRUE(queue.empty());
+}
+
+#endif  // !TESTS_OUT_QUEUE_TESTS_HPP
@@ -0,0 +1,94 @@
+/**
+ * @file   queue_tests.hpp
+ * @author Pratchaya Khansomboon (me@mononerv.dev)
+ * @brief  Fixed size queue tests.
+ * @date   2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ */
+#ifndef TESTS_QUEUE_TESTS_HPP
+#define TESTS_QUEUE_TESTS_HPP
+
+#include <cstdint>
+
+#include "gtest/gtest.h"
+#include "queue.hpp"
+
+TEST(sky_queue, overwrites_oldest_when_full) {
+    sky::queue<std::int32_t, 4> queue{};
+    for (std::int32_t i = 0; i < 6; ++i) queue.enq(i);
+    EXPECT_EQ(queue.size(), 4u);
+    EXPECT_EQ(queue.overwritten(), 2u);
+    for (std::int32_t i = 2; i < 6; ++i) EXPECT_EQ(queue.deq(), i);
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(sky_queue, emplace_front_and_pop) {
+    struct item {
+        std::int32_t a;
+        std::int32_t b;
+    };
+    sky::queue<item, 4> queue{};
+    auto& slot = queue.emplace(1, 2);
+    slot.b = 3;
+    queue.emplace(4, 5);
+
+    EXPECT_EQ(queue.front().a, 1);
+    EXPECT_EQ(queue.front().b, 3);
+    queue.pop();
+    EXPECT_EQ(queue.front().a, 4);
+    queue.pop();
+    EXPECT_TRUE(queue.empty());
+    queue.pop();
+    EXPECT_EQ(queue.size(), 0u);
+}
+
+TEST(sky_queue, emplace_constructs_in_place) {
+    // Neither assignable nor movable, emplace can only build it in the slot
+    struct pinned {
+        std::int32_t value = 0;
+        pinned() = default;
+        explicit pinned(std::int32_t v) noexcept : value(v) {}
+        pinned(pinned const&) = delete;
+        pinned& operator=(pinned const&) = delete;
+    };
+    sky::queue<pinned, 2> queue{};
+    queue.emplace(1);
+    queue.emplace(2);
+    auto& slot = queue.emplace(3);
+    EXPECT_EQ(slot.value, 3);
+    EXPECT_EQ(queue.overwritten(), 1u);
+    EXPECT_EQ(queue.front().value, 2);
+    EXPECT_EQ(&queue.at(1), &slot);
+}
+
+TEST(sky_queue, bulk_copies_wrap_around) {
+    sky::queue<std::int32_t, 8> queue{};
+    std::int32_t const data[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    std::int32_t out[10]{};
+
+    EXPECT_EQ(queue.try_enq_n(data, 6), 6u);
+    EXPECT_EQ(queue.deq_n(out, 5), 5u);
+    // Tail is at 6, the next run wraps to the start of the buffer
+    EXPECT_EQ(queue.try_enq_n(data + 6, 4), 4u);
+    EXPECT_EQ(queue.size(), 5u);
+    // Only the free slots are filled, nothing is overwritten
+    EXPECT_EQ(queue.try_enq_n(data, 10), 3u);
+    EXPECT_EQ(queue.overwritten(), 0u);
+
+    EXPECT_EQ(queue.deq_n(out, 10), 8u);
+    std::int32_t const expected[] = {5, 6, 7, 8, 9, 0, 1, 2};
+    for (std::size_t i = 0; i < 8; ++i) EXPECT_EQ(out[i], expected[i]);
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(sky_queue, at_counts_from_the_front) {
+    sky::queue<std::int32_t, 4> queue{};
+    for (std::int32_t i = 0; i < 6; ++i) queue.enq(i);
+    for (std::size_t i = 0; i < queue.size(); ++i) EXPECT_EQ(queue.at(i), static_cast<std::int32_t>(i) + 2);
+    queue.at(1) = 42;
+    queue.pop();
+    EXPECT_EQ(queue.front(), 42);
+}
+
+#endif  // !TESTS_QUEUE_TESTS_HPP
@@ -0,0 +1,112 @@
+/**
+ * @file   scheduler_tests.hpp
+ * @author Pratchaya Khansomboon (me@mononerv.dev)
+ * @brief  multicom slot policies.
+ * @date   2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ */
+#ifndef TESTS_SCHEDULER_TESTS_HPP
+#define TESTS_SCHEDULER_TESTS_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#include "gtest/gtest.h"
+#include "scheduler.hpp"
+#include "mesh.hpp"
+
+TEST(sunlight_scheduler, round_robin_visits_every_channel_in_turn) {
+    ray::round_robin_scheduler scheduler{};
+    scheduler.seed(7);
+    std::size_t const pending[ray::MAX_CHANNEL]{3, 0, 0, 0};
+    auto current = scheduler.first();
+    EXPECT_EQ(current.channel, 0);
+    for (std::size_t i = 0; i < 40; ++i) {
+        auto const next = scheduler.next(current.channel, {}, pending);
+        EXPECT_EQ(next.channel, (current.channel + 1) % ray::MAX_CHANNEL);
+        EXPECT_GE(next.interval_us, 16000u);
+        EXPECT_LT(next.interval_us, 66000u);
+        current = next;
+    }
+    EXPECT_EQ(scheduler.min_slots(1, 0), 3u);
+    EXPECT_EQ(scheduler.min_slots(2, 2), 0u);
+    EXPECT_EQ(scheduler.linger_us(), 0u);
+}
+
+TEST(sunlight_scheduler, adaptive_backs_off_silent_channels) {
+    ray::adaptive_scheduler scheduler{};
+    scheduler.seed(7);
+    std::size_t const idle[ray::MAX_CHANNEL]{};
+    std::size_t visits[ray::MAX_CHANNEL]{};
+    uint8_t channel = 0;
+    // Channel 2 keeps receiving, the others are silent
+    for (std::size_t i = 0; i < 200; ++i) {
+        ray::slot_outcome outcome{};
+        outcome.received = channel == 2;
+        auto const next = scheduler.next(channel, outcome, idle);
+        EXPECT_GE(next.interval_us, scheduler.min_us());
+        ++visits[next.channel];
+        channel = next.channel;
+    }
+    EXPECT_GT(visits[2], visits[0]);
+    EXPECT_GT(visits[2], visits[1]);
+    EXPECT_GT(visits[2], visits[3]);
+    // Backed off, never dropped
+    for (auto const count : visits) EXPECT_GT(count, 10u);
+    EXPECT_EQ(scheduler.min_slots(1, 0), 1u);
+    EXPECT_GT(scheduler.linger_us(), 0u);
+}
+
+TEST(sunlight_scheduler, adaptive_goes_to_pending_output) {
+    ray::adaptive_scheduler scheduler{};
+    scheduler.seed(3);
+    std::size_t const idle[ray::MAX_CHANNEL]{};
+    uint8_t channel = 0;
+    // Long enough silence for every channel to be at full back off
+    for (std::size_t i = 0; i < 40; ++i) channel = scheduler.next(channel, {}, idle).channel;
+
+    std::size_t pending[ray::MAX_CHANNEL]{};
+    pending[(channel + 3) % ray::MAX_CHANNEL] = 1;
+    auto const next = scheduler.next(channel, {}, pending);
+    // Skipped channels on the way are passed, output waiting is not
+    EXPECT_NE(next.channel, channel);
+    std::size_t hops = 0;
+    auto at = next.channel;
+    while (at != (channel + 3) % ray::MAX_CHANNEL && hops < 8) {
+        at = scheduler.next(at, {}, pending).channel;
+        ++hops;
+    }
+    EXPECT_LE(hops, 2u);
+    EXPECT_LT(next.interval_us, scheduler.max_us());
+}
+
+TEST(sunlight_scheduler, adaptive_mesh_delivers_more) {
+    ray::mesh_config config{};
+    config.seed = 5;
+    auto round_robin = ray::make_grid_mesh(5, 5, config);
+    config.schedule = ray::mesh_schedule::adaptive;
+    auto adaptive = ray::make_grid_mesh(5, 5, config);
+    round_robin->set_exit(24);
+    adaptive->set_exit(24);
+    round_robin->run_until(40'000'000);
+    adaptive->run_until(40'000'000);
+
+    auto const slow = round_robin->report();
+    auto const fast = adaptive->report();
+    EXPECT_GT(fast.frames, slow.frames);
+    EXPECT_LT(fast.bytes_lost, slow.bytes_lost);
+    ASSERT_GE(fast.exit_reached_us, 0);
+    if (slow.exit_reached_us >= 0) {
+        EXPECT_LE(fast.exit_reached_us, slow.exit_reached_us);
+    }
+
+    // The counters add up to the totals
+    uint64_t packets = 0;
+    for (std::size_t i = 0; i < adaptive->size(); ++i) {
+        for (uint8_t ch = 0; ch < ray::MAX_CHANNEL; ++ch) packets += adaptive->counters(i, ch).packets_out;
+    }
+    EXPECT_EQ(packets, fast.packets_sent);
+}
+
+#endif  // !TESTS_SCHEDULER_TESTS_HPP
@@ -0,0 +1,91 @@
+/**
+ * @file   sparse_topo_tests.hpp
+ * @author Pratchaya Khansomboon (me@mononerv.dev)
+ * @brief  Compressed sparse row topology and Dijkstra shortest path tests.
+ * @date   2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ */
+#ifndef TESTS_SPARSE_TOPO_TESTS_HPP
+#define TESTS_SPARSE_TOPO_TESTS_HPP
+
+#include <memory>
+
+#include "gtest/gtest.h"
+#include "sparse_topo.hpp"
+
+TEST(sky_sparse_topo, from_dense_and_shortest_path) {
+    sky::topo topology{};
+    for (std::size_t i = 0; i < sky::node_size; ++i)
+        for (std::size_t j = 0; j < sky::node_size; ++j)
+            topology.matrix[i][j] = i == j ? 0 : -1;
+    // 0 - 1 - 2 - 4, 3 in fire mode
+    sky::topo_set_node_link_cost(topology, 0, 1, 1);
+    sky::topo_set_node_link_cost(topology, 1, 2, 1);
+    sky::topo_set_node_link_cost(topology, 2, 4, 1);
+    sky::topo_set_node_firemode(topology, 3);
+
+    sky::sparse_topo<sky::node_size, 64> sparse{};
+    ASSERT_TRUE(sky::sparse_topo_from_dense(sparse, topology));
+    EXPECT_EQ(sparse.row[sky::node_size], 6u);
+    EXPECT_TRUE(sparse.fire[3]);
+
+    std::uint32_t path[sky::node_size]{};
+    ASSERT_EQ(sky::sparse_topo_compute_dijkstra(sparse, 0, 4, path, sky::length_of(path)), 4u);
+    EXPECT_EQ(path[0], 0u);
+    EXPECT_EQ(path[1], 1u);
+    EXPECT_EQ(path[2], 2u);
+    EXPECT_EQ(path[3], 4u);
+    EXPECT_EQ(sky::sparse_topo_compute_dijkstra(sparse, 3, 4, path, sky::length_of(path)), 0u);
+}
+
+TEST(sky_sparse_topo, link_cost_and_firemode) {
+    sky::sparse_topo<6, 12> topology{};
+    sky::sparse_topo_clear(topology);
+    // Square 0-1-2-3 with a cheap detour 0-4-5-2
+    EXPECT_TRUE(sky::sparse_topo_set_node_link_cost(topology, 0, 1, 5));
+    EXPECT_TRUE(sky::sparse_topo_set_node_link_cost(topology, 1, 2, 5));
+    EXPECT_TRUE(sky::sparse_topo_set_node_link_cost(topology, 2, 3, 1));
+    EXPECT_TRUE(sky::sparse_topo_set_node_link_cost(topology, 0, 4, 1));
+    EXPECT_TRUE(sky::sparse_topo_set_node_link_cost(topology, 4, 5, 1));
+    EXPECT_TRUE(sky::sparse_topo_set_node_link_cost(topology, 5, 2, 1));
+    EXPECT_FALSE(sky::sparse_topo_set_node_link_cost(topology, 1, 3, 1));  // No room left
+
+    std::uint32_t path[6]{};
+    ASSERT_EQ(sky::sparse_topo_compute_dijkstra(topology, 0, 3, path, 6), 5u);
+    EXPECT_EQ(path[1], 4u);
+
+    sky::sparse_topo_set_node_firemode(topology, 5);
+    EXPECT_EQ(topology.row[6], 8u);
+    ASSERT_EQ(sky::sparse_topo_compute_dijkstra(topology, 0, 3, path, 6), 4u);
+    EXPECT_EQ(path[1], 1u);
+
+    // Removing a link frees room for another
+    EXPECT_TRUE(sky::sparse_topo_set_node_link_cost(topology, 1, 2, -1));
+    EXPECT_EQ(sky::sparse_topo_compute_dijkstra(topology, 0, 3, path, 6), 0u);
+    EXPECT_TRUE(sky::sparse_topo_set_node_link_cost(topology, 1, 3, 1));
+    EXPECT_EQ(sky::sparse_topo_compute_dijkstra(topology, 0, 3, path, 6), 3u);
+    EXPECT_EQ(sky::sparse_topo_compute_dijkstra(topology, 0, 3, path, 2), 0u);  // Does not fit
+}
+
+TEST(sky_sparse_topo, large_grid) {
+    constexpr std::uint32_t side = 64;
+    using grid_t = sky::sparse_topo<side * side, side * side * 4>;
+    auto topology = std::make_unique<grid_t>();
+    sky::sparse_topo_clear(*topology);
+    for (std::uint32_t y = 0; y < side; ++y) {
+        for (std::uint32_t x = 0; x < side; ++x) {
+            auto const i = y * side + x;
+            if (x + 1 < side) {
+                ASSERT_TRUE(sky::sparse_topo_set_node_link_cost(*topology, i, i + 1, 1));
+            }
+            if (y + 1 < side) {
+                ASSERT_TRUE(sky::sparse_topo_set_node_link_cost(*topology, i, i + side, 1));
+            }
+        }
+    }
+    std::uint32_t path[side * 2]{};
+    EXPECT_EQ(sky::sparse_topo_compute_dijkstra(*topology, 0, side * side - 1, path, sky::length_of(path)), side * 2 - 1);
+}
+
+#endif  // !TESTS_SPARSE_TOPO_TESTS_HPP
@@ -0,0 +1,59 @@
+/**
+ * @file   spsc_queue_tests.hpp
+ * @author Pratchaya Khansomboon (me@mononerv.dev)
+ * @brief  Single-producer/single-consumer queue tests.
+ * @date   2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ */
+#ifndef TESTS_SPSC_QUEUE_TESTS_HPP
+#define TESTS_SPSC_QUEUE_TESTS_HPP
+
+#include <cstdint>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "spsc_queue.hpp"
+
+TEST(sky_spsc_queue, fails_when_full_and_empty) {
+    sky::spsc_queue<std::int32_t, 4> queue{};
+    std::int32_t value = 0;
+    EXPECT_TRUE(queue.empty());
+    EXPECT_FALSE(queue.try_deq(value));
+
+    for (std::int32_t i = 0; i < 4; ++i) EXPECT_TRUE(queue.try_enq(i));
+    EXPECT_FALSE(queue.try_enq(4));
+    EXPECT_EQ(queue.size(), 4u);
+
+    for (std::int32_t i = 0; i < 4; ++i) {
+        EXPECT_TRUE(queue.try_deq(value));
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_FALSE(queue.try_deq(value));
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(sky_spsc_queue, keeps_order_across_threads) {
+    constexpr std::uint32_t count = 100000;
+    sky::spsc_queue<std::uint32_t, 64> queue{};
+    std::thread producer([&queue] {
+        for (std::uint32_t i = 0; i < count; ++i) {
+            while (!queue.try_enq(i)) std::this_thread::yield();
+        }
+    });
+
+    std::uint32_t expected = 0;
+    std::uint32_t value = 0;
+    while (expected < count) {
+        if (!queue.try_deq(value)) {
+            std::this_thread::yield();
+            continue;
+        }
+        EXPECT_EQ(value, expected);
+        ++expected;
+    }
+    producer.join();
+    EXPECT_TRUE(queue.empty());
+}
+
+#endif  // !TESTS_SPSC_QUEUE_TESTS_HPP
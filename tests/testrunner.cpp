@@ -12,8 +12,23 @@
 #include "fmt/format.h"
 #include "sky.hpp"
 
+#include "address_map_tests.hpp"
+#include "crc_tests.hpp"
+#include "dedup_tests.hpp"
+#include "deframer_tests.hpp"
+#include "exit_tree_tests.hpp"
+#include "frame_relay_tests.hpp"
+#include "link_state_tests.hpp"
 #include "mcp_tests.hpp"
+#include "mesh_tests.hpp"
+#include "node_tests.hpp"
+#include "out_queue_tests.hpp"
+#include "queue_tests.hpp"
+#include "scheduler_tests.hpp"
+#include "sparse_topo_tests.hpp"
+#include "spsc_queue_tests.hpp"
 #include "topo_tests.hpp"
+#include "trace_tests.hpp"
 #include "utility_tests.hpp"
 
 auto main(int argc, char const* argv[]) -> int {
@@ -10,7 +10,11 @@
 #ifndef TEST_TOPO_TESTS_HPP
 #define TEST_TOPO_TESTS_HPP
 
+#include <memory>
+#include <random>
+
 #include "gtest/gtest.h"
+#include "topo_reference.hpp"
 
 TEST(sky_topo, topo_set_node_firemode) {
     sky::topo topology;
@@ -72,4 +76,251 @@ TEST(sky_topo, topo_compute_dijkstra) {
     fmt::print("\n");
 
 }
+
+TEST(sky_topo, topo_compute_exit_tree) {
+    sky::topo topology{};
+    for (size_t i = 0; i < sky::node_size; i++)
+        for (size_t j = 0; j < sky::node_size; j++)
+            topology.matrix[i][j] = i == j ? 0 : -1;
+    // 1 - 2 - 3 - 5 (exit), 1 - 4 - 5 is longer, 6 is alone
+    sky::topo_set_node_link_cost(topology, 0, 1, 1);
+    sky::topo_set_node_link_cost(topology, 1, 2, 1);
+    sky::topo_set_node_link_cost(topology, 2, 4, 1);
+    sky::topo_set_node_link_cost(topology, 0, 3, 2);
+    sky::topo_set_node_link_cost(topology, 3, 4, 2);
+
+    sky::topo_tree_t next{};
+    sky::topo_tree_t distance{};
+    sky::topo_compute_exit_tree(topology, 5, next, distance);
+    int32_t const expected_next[] = {2, 3, 5, 5, 5, 0};
+    int32_t const expected_distance[] = {3, 2, 1, 2, 0, -1};
+    for (size_t i = 0; i < 6; i++) {
+        EXPECT_EQ(next[i], expected_next[i]) << "node: " << i + 1;
+        EXPECT_EQ(distance[i], expected_distance[i]) << "node: " << i + 1;
+    }
+
+    sky::topo_shortest_t path{};
+    sky::topo_exit_path(next, 1, path);
+    sky::topo_shortest_t expected_path = { 1,2,3,5,0,0,0,0,0,0,0,0,0,0,0,0 };
+    for (size_t i = 0; i < sky::max_path; i++) EXPECT_EQ(path[i], expected_path[i]);
+
+    // Node 3 on fire, the way out goes through 4
+    sky::topo_set_node_firemode(topology, 2);
+    sky::topo_compute_exit_tree(topology, 5, next, distance);
+    EXPECT_EQ(next[0], 4);
+    EXPECT_EQ(distance[0], 4);
+    EXPECT_EQ(next[2], 0);
+    sky::topo_exit_path(next, 3, path);
+    EXPECT_EQ(path[0], 0);
+}
+
+TEST(sky_topo, topo_compute_nearest_exit) {
+    sky::topo topology{};
+    for (size_t i = 0; i < sky::node_size; i++)
+        for (size_t j = 0; j < sky::node_size; j++)
+            topology.matrix[i][j] = i == j ? 0 : -1;
+    // 1 (exit) - 2 - 3 - 4 - 5 (exit), 6 is alone
+    sky::topo_set_node_link_cost(topology, 0, 1, 1);
+    sky::topo_set_node_link_cost(topology, 1, 2, 1);
+    sky::topo_set_node_link_cost(topology, 2, 3, 2);
+    sky::topo_set_node_link_cost(topology, 3, 4, 1);
+
+    int32_t const exits[] = {1, 5};
+    sky::topo_tree_t next{};
+    sky::topo_tree_t distance{};
+    sky::topo_tree_t exit{};
+    sky::topo_compute_nearest_exit(topology, exits, 2, next, distance, exit);
+    int32_t const expected_next[] = {1, 1, 2, 5, 5, 0};
+    int32_t const expected_distance[] = {0, 1, 2, 1, 0, -1};
+    int32_t const expected_exit[] = {1, 1, 1, 5, 5, 0};
+    for (size_t i = 0; i < 6; i++) {
+        EXPECT_EQ(next[i], expected_next[i]) << "node: " << i + 1;
+        EXPECT_EQ(distance[i], expected_distance[i]) << "node: " << i + 1;
+        EXPECT_EQ(exit[i], expected_exit[i]) << "node: " << i + 1;
+    }
+
+    // Exit 1 on fire, everyone goes to 5
+    sky::topo_set_node_firemode(topology, 0);
+    sky::topo_compute_nearest_exit(topology, exits, 2, next, distance, exit);
+    EXPECT_EQ(exit[1], 5);
+    EXPECT_EQ(distance[1], 4);
+    EXPECT_EQ(exit[0], 0);
+}
+TEST(sky_topo, topo_compute_balanced_exits) {
+    sky::topo topology{};
+    for (size_t i = 0; i < sky::node_size; i++)
+        for (size_t j = 0; j < sky::node_size; j++)
+            topology.matrix[i][j] = i == j ? 0 : -1;
+    // Exit 1 behind a short corridor 2 and a longer one 3, rooms 4-9 open to both
+    sky::topo_set_node_link_cost(topology, 0, 1, 1);
+    sky::topo_set_node_link_cost(topology, 0, 2, 2);
+    for (uint32_t i = 3; i < 9; i++) {
+        sky::topo_set_node_link_cost(topology, i, 1, 1);
+        sky::topo_set_node_link_cost(topology, i, 2, 1);
+    }
+    int32_t const exits[] = {1};
+    sky::topo::capacity_t capacity{};
+    for (auto& row : capacity)
+        for (auto& link : row) link = 4;
+
+    sky::topo_tree_t next{};
+    sky::topo_tree_t load{};
+    // No rounds is the nearest exit tree, everyone down corridor 2
+    EXPECT_EQ(sky::topo_compute_balanced_exits(topology, exits, 1, capacity, 0, next), 7);
+    EXPECT_EQ(sky::topo_compute_exit_load(next, load), 7);
+    EXPECT_EQ(load[1], 7);
+
+    auto const max_load = sky::topo_compute_balanced_exits(topology, exits, 1, capacity, 8, next);
+    EXPECT_LT(max_load, 7);
+    EXPECT_EQ(sky::topo_compute_exit_load(next, load), max_load);
+    EXPECT_GT(load[2], 0);
+    auto const uniform_load = load[2];
+    for (int32_t i = 1; i <= 9; i++) {
+        sky::topo_shortest_t path{};
+        sky::topo_exit_path(next, i, path);
+        EXPECT_EQ(path[0], i);
+        auto const length = std::count_if(path, path + sky::max_path, [](int32_t node) { return node != 0; });
+        EXPECT_EQ(path[length - 1], 1) << "node: " << i;
+    }
+
+    // A wide corridor 2 takes everyone again, a narrow one sends more of them to 3
+    capacity[1][0] = 100;
+    EXPECT_EQ(sky::topo_compute_balanced_exits(topology, exits, 1, capacity, 8, next), 7);
+    EXPECT_EQ(sky::topo_compute_exit_load(next, load), 7);
+    EXPECT_EQ(load[1], 7);
+    capacity[1][0] = 1;
+    sky::topo_compute_balanced_exits(topology, exits, 1, capacity, 8, next);
+    sky::topo_compute_exit_load(next, load);
+    EXPECT_GT(load[2], uniform_load);
+}
+
+// Random undirected topology, a few nodes in firemode. Costs are 1 when max_cost is 1.
+static auto topo_random(std::mt19937& rng, int8_t max_cost) -> sky::topo {
+    std::uniform_int_distribution<int> chance{0, 99};
+    std::uniform_int_distribution<int> cost{1, max_cost};
+    sky::topo topology{};
+    for (size_t i = 0; i < sky::node_size; i++)
+        for (size_t j = 0; j < sky::node_size; j++)
+            topology.matrix[i][j] = i == j ? 0 : -1;
+    for (uint32_t i = 0; i < sky::node_size; i++)
+        for (uint32_t j = i + 1; j < sky::node_size; j++)
+            if (chance(rng) < 20) sky::topo_set_node_link_cost(topology, i, j, static_cast<int8_t>(cost(rng)));
+    for (uint32_t i = 0; i < sky::node_size; i++)
+        if (chance(rng) < 5) sky::topo_set_node_firemode(topology, i);
+    return topology;
+}
+
+// Cost of the path or -1 if it is not a path from src to dest over existing links.
+static auto topo_path_cost(sky::topo const& topology, sky::topo_shortest_t const& path, int32_t src, int32_t dest) -> int32_t {
+    if (path[0] != src) return -1;
+    int32_t cost = 0;
+    size_t i = 1;
+    for (; i < sky::max_path && path[i] != 0; i++) {
+        auto const link = topology.matrix[path[i - 1] - 1][path[i] - 1];
+        if (link <= 0) return -1;
+        cost += link;
+    }
+    return path[i - 1] == dest ? cost : -1;
+}
+
+// All pairs shortest cost with Floyd-Warshall, -1 when unreachable.
+static auto topo_all_pairs(sky::topo const& topology, int32_t (&cost)[sky::node_size][sky::node_size]) -> void {
+    constexpr int32_t inf = 1 << 20;
+    for (size_t i = 0; i < sky::node_size; i++)
+        for (size_t j = 0; j < sky::node_size; j++)
+            cost[i][j] = i == j ? 0 : topology.matrix[i][j] > 0 ? topology.matrix[i][j] : inf;
+    for (size_t k = 0; k < sky::node_size; k++)
+        for (size_t i = 0; i < sky::node_size; i++)
+            for (size_t j = 0; j < sky::node_size; j++)
+                if (cost[i][k] + cost[k][j] < cost[i][j]) cost[i][j] = cost[i][k] + cost[k][j];
+    for (size_t i = 0; i < sky::node_size; i++)
+        for (size_t j = 0; j < sky::node_size; j++)
+            if (cost[i][j] == inf || topology.matrix[i][i] == -1 || topology.matrix[j][j] == -1) cost[i][j] = -1;
+}
+
+// The reference is not always optimal, the new engine must match the optimum and never do worse.
+static auto topo_differential(int8_t max_cost) -> void {
+    std::mt19937 rng{static_cast<std::mt19937::result_type>(2022 + max_cost)};
+    size_t compared = 0;
+    for (auto round = 0; round < 200; round++) {
+        auto const topology = topo_random(rng, max_cost);
+        int32_t optimum[sky::node_size][sky::node_size]{};
+        topo_all_pairs(topology, optimum);
+        for (int32_t src = 1; src <= static_cast<int32_t>(sky::node_size); src++) {
+            for (int32_t dest = 1; dest <= static_cast<int32_t>(sky::node_size); dest++) {
+                sky::topo_shortest_t expected{};
+                sky::topo_shortest_t output{};
+                topo_compute_dijkstra_reference(topology, src, dest, expected);
+                sky::topo_compute_dijkstra(topology, src, dest, output);
+
+                auto const expected_cost = topo_path_cost(topology, expected, src, dest);
+                auto const output_cost = topo_path_cost(topology, output, src, dest);
+                EXPECT_EQ(output_cost, optimum[src - 1][dest - 1]) << "src: " << src << ", dest: " << dest;
+                if (expected_cost < 0) continue;
+                compared++;
+                EXPECT_LE(output_cost, expected_cost) << "src: " << src << ", dest: " << dest;
+            }
+        }
+    }
+    EXPECT_GT(compared, 0u);
+}
+
+TEST(sky_topo, topo_compute_dijkstra_differential_unit_cost) {
+    topo_differential(1);
+}
+
+TEST(sky_topo, topo_compute_dijkstra_differential_weighted) {
+    topo_differential(9);
+}
+
+// Path cost from topo_compute_dijkstra against the exit tree rooted at dest on a random
+// weighted topology of N nodes, both searches are independent.
+template <size_t N, typename Index>
+static auto topo_sized_differential() -> void {
+    using topo_t = sky::basic_topo<N, Index>;
+    std::mt19937 rng{N};
+    std::uniform_int_distribution<int> chance{0, 99};
+    std::uniform_int_distribution<int> cost{1, 9};
+    auto topology = std::make_unique<topo_t>();
+    for (size_t i = 0; i < N; i++)
+        for (size_t j = 0; j < N; j++)
+            topology->matrix[i][j] = i == j ? 0 : -1;
+    for (uint32_t i = 0; i < N; i++)
+        for (uint32_t j = i + 1; j < N; j++)
+            if (chance(rng) < 400 / static_cast<int>(N)) sky::topo_set_node_link_cost(*topology, i, j, static_cast<int8_t>(cost(rng)));
+    sky::topo_set_node_firemode(*topology, 2);
+
+    size_t reached = 0;
+    for (int32_t dest = 1; dest <= static_cast<int32_t>(N); dest += static_cast<int32_t>(N / 6 + 1)) {
+        typename topo_t::tree_t next{};
+        typename topo_t::cost_t distance{};
+        sky::topo_compute_exit_tree(*topology, dest, next, distance);
+        for (int32_t src = 1; src <= static_cast<int32_t>(N); src++) {
+            typename topo_t::path_t path{};
+            sky::topo_compute_dijkstra(*topology, src, dest, path);
+            if (distance[src - 1] < 0) {
+                EXPECT_EQ(path[0], 0) << "src: " << src << ", dest: " << dest;
+                continue;
+            }
+            ASSERT_EQ(path[0], static_cast<Index>(src));
+            int32_t path_cost = 0;
+            size_t k = 1;
+            for (; k < N && path[k] != 0; k++) path_cost += topology->matrix[path[k - 1] - 1][path[k] - 1];
+            EXPECT_EQ(path[k - 1], static_cast<Index>(dest));
+            EXPECT_EQ(path_cost, distance[src - 1]) << "src: " << src << ", dest: " << dest;
+            reached++;
+        }
+    }
+    EXPECT_GT(reached, N);
+}
+
+TEST(sky_topo, basic_topo_sizes) {
+    static_assert(sizeof(sky::basic_topo<16, uint8_t>::path_t) * 4 == sizeof(sky::topo_shortest_t));
+    static_assert(sizeof(sky::basic_topo<300, uint16_t>::tree_t) == 600);
+    topo_sized_differential<16, uint8_t>();
+    topo_sized_differential<16, int32_t>();
+    topo_sized_differential<48, uint8_t>();   // 64-bit masks
+    topo_sized_differential<100, uint8_t>();  // Arrays, no masks
+    topo_sized_differential<300, uint16_t>();
+}
 #endif  // !TEST_TOPO_TESTS_HPP
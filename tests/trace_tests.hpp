@@ -0,0 +1,126 @@
+/**
+ * @file   trace_tests.hpp
+ * @author Pratchaya Khansomboon (me@mononerv.dev)
+ * @brief  Node trace format, recording and replay.
+ * @date   2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ */
+#ifndef TESTS_TRACE_TESTS_HPP
+#define TESTS_TRACE_TESTS_HPP
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "trace.hpp"
+#include "trace_file.hpp"
+#include "replay.hpp"
+#include "mesh.hpp"
+
+TEST(sunlight_trace, record_round_trip) {
+    ray::trace_record rec{};
+    rec.time = 0x01020304;
+    rec.sent = true;
+    rec.pkt.channel = 3;
+    rec.pkt.size = 5;
+    for (std::uint8_t i = 0; i < 5; ++i) rec.pkt.data[i] = static_cast<std::uint8_t>(0xA0 + i);
+
+    std::uint8_t buffer[ray::trace_record_max]{};
+    auto const size = ray::encode_trace_record(buffer, rec);
+    EXPECT_EQ(size, ray::trace_record_header + 5);
+    EXPECT_EQ(buffer[0], 0x04);
+    EXPECT_EQ(buffer[4], 0x83);
+
+    ray::trace_record out{};
+    EXPECT_EQ(ray::decode_trace_record(buffer, size, out), size);
+    EXPECT_EQ(out.time, rec.time);
+    EXPECT_TRUE(out.sent);
+    EXPECT_EQ(out.pkt.channel, 3);
+    EXPECT_EQ(out.pkt.size, 5);
+    EXPECT_EQ(out.pkt.data[4], 0xA4);
+
+    // Cut short or out of range is not a record
+    EXPECT_EQ(ray::decode_trace_record(buffer, size - 1, out), 0u);
+    buffer[5] = 33;
+    EXPECT_EQ(ray::decode_trace_record(buffer, sizeof(buffer), out), 0u);
+}
+
+TEST(sunlight_trace, file_round_trip) {
+    auto const path = ::testing::TempDir() + "sunlight_file_round_trip.trc";
+    {
+        ray::trace_writer writer(path, 0x00ABCDEF);
+        ASSERT_TRUE(writer.is_open());
+        for (std::uint32_t i = 0; i < 100; ++i) {
+            ray::trace_record rec{};
+            rec.time = i * 10;
+            rec.sent = i % 3 == 0;
+            rec.pkt.channel = static_cast<std::uint8_t>(i % ray::MAX_CHANNEL);
+            rec.pkt.size = static_cast<std::uint8_t>(i % 33);
+            rec.pkt.data[0] = static_cast<std::uint8_t>(i);
+            writer.record(rec);
+        }
+        EXPECT_EQ(writer.records(), 100u);
+    }
+
+    ray::trace_file const trace(path);
+    ASSERT_TRUE(trace.is_open());
+    EXPECT_EQ(trace.address(), 0x00ABCDEFu);
+    std::uint32_t count = 0;
+    ray::trace_record rec{};
+    for (auto records = trace.records(); records.next(rec); ++count) {
+        EXPECT_EQ(rec.time, count * 10);
+        EXPECT_EQ(rec.sent, count % 3 == 0);
+        EXPECT_EQ(rec.pkt.channel, count % ray::MAX_CHANNEL);
+        EXPECT_EQ(rec.pkt.size, count % 33);
+        if (rec.pkt.size > 0) {
+            EXPECT_EQ(rec.pkt.data[0], count);
+        }
+    }
+    EXPECT_EQ(count, 100u);
+    std::remove(path.c_str());
+
+    ray::trace_file const missing(path);
+    EXPECT_FALSE(missing.is_open());
+    EXPECT_FALSE(missing.records().next(rec));
+}
+
+TEST(sunlight_trace, replay_matches_recorded_node) {
+    auto const path = ::testing::TempDir() + "sunlight_replay.trc";
+    auto sim = ray::make_grid_mesh(4, 4);
+    sim->set_exit(15);
+    sim->set_fire(0, 30'000'000);
+    auto const address = sky::mcp_address_to_u32(sim->at(5).address());
+    {
+        ray::trace_writer writer(path, address);
+        ASSERT_TRUE(writer.is_open());
+        sim->set_recorder(5, &writer);
+        sim->run_until(40'000'000);
+        sim->set_recorder(5, nullptr);
+        EXPECT_GT(writer.records(), 0u);
+    }
+
+    ray::trace_file const trace(path);
+    ASSERT_TRUE(trace.is_open());
+    EXPECT_EQ(trace.address(), address);
+
+    // Same bytes on the same channels in the same order, the same frames come out
+    ray::replayer replay(trace.address());
+    auto const report = replay.run(trace);
+    auto const& live = sim->at(5);
+    EXPECT_GT(report.received, 0u);
+    EXPECT_GT(report.sent_recorded, 0u);
+    EXPECT_EQ(report.frames, live.frames_received());
+    EXPECT_EQ(replay.light().addresses().size(), live.addresses().size());
+    EXPECT_EQ(replay.light().exit_count(), live.exit_count());
+
+    // Replay is deterministic
+    ray::replayer again(trace.address());
+    auto const second = again.run(trace);
+    EXPECT_EQ(second.frames, report.frames);
+    EXPECT_EQ(second.sent, report.sent);
+    std::remove(path.c_str());
+}
+
+#endif  // !TESTS_TRACE_TESTS_HPP